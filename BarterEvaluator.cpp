@@ -0,0 +1,172 @@
+#include "BarterEvaluator.h"
+#include <algorithm>
+
+namespace {
+
+constexpr int kMaxRun = 7;
+
+// Points of the best contract inside each 13-bit lane: a Partnership or Silk
+// Road when the lane is one suit, a Trade Route when it is the union of every
+// suit's ranks. Runs score their longest stretch, capped at kMaxRun, or 3 when
+// only Q-K-A wraps.
+struct LaneScores {
+    std::array<std::uint8_t, 1u << kRanksPerSuit> suit;
+    std::array<std::uint8_t, 1u << kRanksPerSuit> route;
+    std::array<std::uint8_t, kNumSuits + 1> monopoly;  // By cards held at one rank
+};
+
+LaneScores makeLaneScores() {
+    LaneScores scores{};
+    for (std::uint32_t lane = 0; lane < (1u << kRanksPerSuit); ++lane) {
+        int length = 0;
+        for (std::uint32_t run = lane; run; run &= run >> 1) ++length;
+        if (length > kMaxRun) length = kMaxRun;
+        if (length < 3) length = (lane & kWrapRun) == kWrapRun ? 3 : 0;
+
+        int count = std::min(popCount(lane), kMaxRun);
+        int suit = count >= 3 ? Contract::calculatePoints(ContractType::PARTNERSHIP, count) : 0;
+        int route = 0;
+        if (length) {
+            suit = std::max(suit, Contract::calculatePoints(ContractType::SILK_ROAD, length));
+            route = Contract::calculatePoints(ContractType::TRADE_ROUTE, length);
+        }
+        scores.suit[lane] = static_cast<std::uint8_t>(suit);
+        scores.route[lane] = static_cast<std::uint8_t>(route);
+    }
+    for (int held = 3; held <= kNumSuits; ++held) {
+        scores.monopoly[held] = static_cast<std::uint8_t>(
+            Contract::calculatePoints(ContractType::MONOPOLY, held));
+    }
+    return scores;
+}
+
+const LaneScores kLaneScores = makeLaneScores();
+
+}
+
+BarterEvaluator::BarterEvaluator(const Player& player, const std::vector<Card>& bazaar)
+    : BarterEvaluator(player.getHandMask(), bazaar) {
+    for (const Contract* contract : player.getContracts()) {
+        addContract(contract->getType(), contract->getSize(), contract->getFrontier());
+    }
+}
+
+BarterEvaluator::BarterEvaluator(CardMask hand, const std::vector<Card>& bazaar)
+    : bazaar_(bazaar), reachable_(hand), extensionCards_(0), extensionGain_{} {
+    for (const auto& card : bazaar) {
+        reachable_ |= card.getMask();
+    }
+}
+
+void BarterEvaluator::addContract(ContractType type, int size, CardMask frontier) {
+    int gain = Contract::calculatePoints(type, size + 1) - Contract::calculatePoints(type, size);
+    for (CardMask cards = reachable_ & frontier; cards; cards &= cards - 1) {
+        int index = lowestBitIndex(cards);
+        if (gain > extensionGain_[index]) {
+            extensionGain_[index] = static_cast<std::uint8_t>(gain);
+            extensionCards_ |= CardMask(1) << index;
+        }
+    }
+}
+
+int BarterEvaluator::bestNewContract(CardMask hand) {
+    std::uint32_t lane0 = suitLane(hand, 0), lane1 = suitLane(hand, 1);
+    std::uint32_t lane2 = suitLane(hand, 2), lane3 = suitLane(hand, 3);
+    int best = std::max({kLaneScores.suit[lane0], kLaneScores.suit[lane1],
+                         kLaneScores.suit[lane2], kLaneScores.suit[lane3],
+                         kLaneScores.route[lane0 | lane1 | lane2 | lane3]});
+
+    // A rank held three or more times: at least three of the four lanes share it
+    std::uint32_t triples = (lane0 & lane1 & (lane2 | lane3)) | ((lane0 | lane1) & lane2 & lane3);
+    if (triples) {
+        bool four = (lane0 & lane1 & lane2 & lane3) != 0;
+        best = std::max(best, static_cast<int>(kLaneScores.monopoly[four ? 4 : 3]));
+    }
+    return best;
+}
+
+int BarterEvaluator::scoreWith(CardMask hand, int handScore, int card) const {
+    // Contracts that do not use `card` were already in the hand, so only its
+    // suit, its rank and the run of ranks can beat handScore
+    CardMask with = hand | (CardMask(1) << card);
+    int rank = card % kRanksPerSuit;
+    int held = 0;
+    for (int suit = 0; suit < kNumSuits; ++suit) {
+        held += (with >> (suit * kRanksPerSuit + rank)) & 1;
+    }
+    int best = std::max({handScore,
+                         static_cast<int>(kLaneScores.suit[suitLane(with, card / kRanksPerSuit)]),
+                         static_cast<int>(kLaneScores.route[rankUnion(with)]),
+                         static_cast<int>(kLaneScores.monopoly[held])});
+    if (extensionCards_ & (CardMask(1) << card)) {
+        best = std::max(best, static_cast<int>(extensionGain_[card]));
+    }
+    return best;
+}
+
+int BarterEvaluator::score(CardMask hand) const {
+    int best = bestNewContract(hand);
+    for (CardMask cards = hand & extensionCards_; cards; cards &= cards - 1) {
+        best = std::max(best, static_cast<int>(extensionGain_[lowestBitIndex(cards)]));
+    }
+    return best;
+}
+
+ExchangeDecision BarterEvaluator::bestExchange(CardMask hand, int cost) const {
+    ExchangeDecision best = ExchangeDecision::pass();
+    if (cost <= 0 || popCount(hand) < cost) return best;
+
+    // Offers in card order rather than slot order, so ties take the lowest card
+    // and the choice depends only on which cards are on offer (the bazaar is
+    // hashed as a set)
+    CardMask offers = 0;
+    for (const auto& card : bazaar_) {
+        offers |= card.getMask();
+    }
+
+    // Exchanging only pays if it strictly beats keeping the hand
+    int handScore = score(hand);
+    int bestScore = handScore;
+    CardMask handCards[kDeckSize];
+    int handSize = -1;
+    for (; offers; offers &= offers - 1) {
+        int card = lowestBitIndex(offers);
+        int bound = scoreWith(hand, handScore, card);
+        if (bound <= bestScore) continue;
+
+        // Give-set candidates in rank order, so ties give away the lowest ranks.
+        // Built at the first take worth expanding.
+        if (handSize < 0) {
+            handSize = 0;
+            for (int rank = 0; rank < kRanksPerSuit; ++rank) {
+                for (CardMask column = hand & rankColumn(rank); column; column &= column - 1) {
+                    handCards[handSize++] = column & (~column + 1);
+                }
+            }
+        }
+
+        int slot = 0;
+        while (bazaar_[slot].getIndex() != card) ++slot;
+        CardMask taken = hand | (CardMask(1) << card);
+
+        // Walk every `cost`-card subset of the hand, stopping once the bound is met
+        auto visit = [&](auto& self, int start, int depth, CardMask give) -> bool {
+            if (depth == cost) {
+                int value = score(taken & ~give);
+                if (value > bestScore) {
+                    bestScore = value;
+                    best.trade = true;
+                    best.give = give;
+                    best.bazaarIndex = slot;
+                }
+                return value >= bound;
+            }
+            for (int i = start; i <= handSize - (cost - depth); ++i) {
+                if (self(self, i + 1, depth + 1, give | handCards[i])) return true;
+            }
+            return false;
+        };
+        visit(visit, 0, 0, 0);
+    }
+    return best;
+}
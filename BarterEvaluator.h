@@ -0,0 +1,41 @@
+#ifndef BARTER_EVALUATOR_H
+#define BARTER_EVALUATOR_H
+
+#include "Player.h"
+#include "Strategy.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Picks the exchange for one trade-rights contract: which `cost` cards to give
+// and which bazaar card to take, or no exchange at all. A hand is scored by the
+// most points one deal could make with it: the best new contract inside it, or
+// the best single-card extension of a contract the player already holds.
+//
+// Every (give-set, bazaar-card) pair is covered, but by branch and bound: taking
+// a card without giving anything bounds every give-set for that card, so a take
+// that cannot beat the best found so far is never expanded.
+class BarterEvaluator {
+public:
+    BarterEvaluator(const Player& player, const std::vector<Card>& bazaar);
+    // Without a Player: call addContract for each contract the player holds
+    BarterEvaluator(CardMask hand, const std::vector<Card>& bazaar);
+
+    void addContract(ContractType type, int size, CardMask frontier);
+
+    int score(CardMask hand) const;
+    // score(hand plus `card`), given handScore = score(hand), from the lanes the card touches
+    int scoreWith(CardMask hand, int handScore, int card) const;
+    ExchangeDecision bestExchange(CardMask hand, int cost) const;
+
+    // Points of the most valuable contract that can be signed from `hand`
+    static int bestNewContract(CardMask hand);
+
+private:
+    const std::vector<Card>& bazaar_;
+    CardMask reachable_;       // Only cards in hand or on offer can ever be in a scored hand
+    CardMask extensionCards_;  // Cards that extend one of the player's contracts
+    std::array<std::uint8_t, kDeckSize> extensionGain_;
+};
+
+#endif
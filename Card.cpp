@@ -1,20 +1,7 @@
 #include "Card.h"
 
-Card::Card(Rank rank, Suit suit) : rank_(rank), suit_(suit) {}
-
 std::string Card::toString() const {
-    return rankToString(rank_) + " of " + suitToString(suit_);
-}
-
-bool Card::operator==(const Card& other) const {
-    return rank_ == other.rank_ && suit_ == other.suit_;
-}
-
-bool Card::operator<(const Card& other) const {
-    if (suit_ != other.suit_) {
-        return suit_ < other.suit_;
-    }
-    return rank_ < other.rank_;
+    return rankToString(getRank()) + " of " + suitToString(getSuit());
 }
 
 std::string suitToString(Suit suit) {
@@ -44,4 +31,14 @@ std::string rankToString(Rank rank) {
         case Rank::KING: return "K";
     }
     return "?";
+}
+
+std::vector<Card> cardsFromMask(CardMask mask) {
+    std::vector<Card> cards;
+    cards.reserve(popCount(mask));
+    while (mask) {
+        cards.push_back(Card::fromIndex(lowestBitIndex(mask)));
+        mask &= mask - 1;
+    }
+    return cards;
 }
\ No newline at end of file
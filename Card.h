@@ -1,9 +1,24 @@
 #ifndef CARD_H
 #define CARD_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// One bit per card: bit (suit * 13 + rank - 1), so each suit occupies a 13-bit lane
+using CardMask = std::uint64_t;
+
+constexpr int kRanksPerSuit = 13;
+constexpr int kNumSuits = 4;
+constexpr int kDeckSize = kRanksPerSuit * kNumSuits;
+constexpr std::uint32_t kLaneMask = (1u << kRanksPerSuit) - 1;
+// Q-K-A, as a rank lane: the only run allowed to wrap around
+constexpr std::uint32_t kWrapRun = (1u << 0) | (1u << 11) | (1u << 12);
+
 enum class Suit {
     HEARTS,    // Red Lotus Trading Company
     DIAMONDS,  // Golden Caravan Guild
@@ -16,25 +31,74 @@ enum class Rank {
     EIGHT, NINE, TEN, JACK, QUEEN, KING
 };
 
+// One byte: the deck index (suit * 13 + rank - 1), from which suit and rank
+// are derived. Default-constructed, it is the Ace of Hearts.
 class Card {
 public:
-    Card(Rank rank, Suit suit);
+    Card() = default;
+    Card(Rank rank, Suit suit)
+        : index_(static_cast<std::uint8_t>(static_cast<int>(suit) * kRanksPerSuit + static_cast<int>(rank) - 1)) {}
     
-    Rank getRank() const { return rank_; }
-    Suit getSuit() const { return suit_; }
-    int getRankValue() const { return static_cast<int>(rank_); }
+    Rank getRank() const { return static_cast<Rank>(getRankValue()); }
+    Suit getSuit() const { return static_cast<Suit>(index_ / kRanksPerSuit); }
+    int getRankValue() const { return index_ % kRanksPerSuit + 1; }
+    int getIndex() const { return index_; }
+    CardMask getMask() const { return CardMask(1) << index_; }
+    
+    static Card fromIndex(int index) {
+        Card card;
+        card.index_ = static_cast<std::uint8_t>(index);
+        return card;
+    }
     
     std::string toString() const;
     
-    bool operator==(const Card& other) const;
-    bool operator<(const Card& other) const;
+    bool operator==(const Card& other) const { return index_ == other.index_; }
+    bool operator<(const Card& other) const { return index_ < other.index_; }  // Suit, then rank
     
 private:
-    Rank rank_;
-    Suit suit_;
+    std::uint8_t index_ = 0;
 };
 
+static_assert(sizeof(Card) == 1, "A Card is one byte");
+
 std::string suitToString(Suit suit);
 std::string rankToString(Rank rank);
 
+// Bitboard helpers
+inline int popCount(std::uint64_t bits) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(bits));
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+inline int lowestBitIndex(std::uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// 13-bit rank lane of one suit (bit 0 = Ace, bit 12 = King)
+inline std::uint32_t suitLane(CardMask mask, int suit) {
+    return static_cast<std::uint32_t>(mask >> (suit * kRanksPerSuit)) & kLaneMask;
+}
+
+// Every rank held in any suit, as one lane
+inline std::uint32_t rankUnion(CardMask mask) {
+    return suitLane(mask, 0) | suitLane(mask, 1) | suitLane(mask, 2) | suitLane(mask, 3);
+}
+
+// All four cards of a rank (rankIndex 0 = Ace)
+inline CardMask rankColumn(int rankIndex) {
+    return ((CardMask(1)) | (CardMask(1) << 13) | (CardMask(1) << 26) | (CardMask(1) << 39)) << rankIndex;
+}
+
+std::vector<Card> cardsFromMask(CardMask mask);
+
 #endif
\ No newline at end of file
@@ -1,61 +1,134 @@
 #include "Contract.h"
-#include <algorithm>
+#include <array>
 #include <sstream>
-#include <set>
+#include <stdexcept>
+
+namespace {
+
+constexpr int kNumContractTypes = 4;
+// Points by [ContractType][card count]; zero where the size is not scored
+constexpr std::array<std::array<int, kMaxContractCards + 1>, kNumContractTypes> kPointsTable = {{
+    {{0, 0, 0, 3, 5, 8, 12, 18, 22, 27}},  // Partnership
+    {{0, 0, 0, 4, 6, 10, 15, 22, 0, 0}},   // Trade Route
+    {{0, 0, 0, 5, 12, 0, 0, 0, 0, 0}},     // Monopoly
+    {{0, 0, 0, 7, 11, 18, 27, 40, 0, 0}}   // Silk Road
+}};
+
+constexpr bool computeIsRun(std::uint32_t rankMask) {
+    if (rankMask == kWrapRun) return true;
+    if (rankMask == 0) return false;
+    
+    int low = 0;
+    while (!(rankMask & (1u << low))) ++low;
+    std::uint32_t run = rankMask >> low;
+    int length = 0;
+    while (run & 1u) {
+        run >>= 1;
+        ++length;
+    }
+    return run == 0 && length >= 3 && length <= ContractUniverse::kMaxSize;
+}
+
+// One bit per 13-bit rank mask: set when the ranks form a legal run
+constexpr std::array<std::uint64_t, (1u << kRanksPerSuit) / 64> makeRunTable() {
+    std::array<std::uint64_t, (1u << kRanksPerSuit) / 64> table{};
+    for (std::uint32_t mask = 0; mask < (1u << kRanksPerSuit); ++mask) {
+        if (computeIsRun(mask)) {
+            table[mask / 64] |= std::uint64_t(1) << (mask % 64);
+        }
+    }
+    return table;
+}
+
+constexpr auto kRunTable = makeRunTable();
+
+static_assert(computeIsRun(0x7), "A-2-3 is a run");
+static_assert(computeIsRun(kWrapRun), "Q-K-A is a run");
+static_assert(!computeIsRun(0x1C01), "J-Q-K-A is not a run");
+
+}
 
 Contract::Contract(ContractType type, const std::vector<Card>& cards, int roundCreated)
-    : type_(type), cards_(cards), roundCreated_(roundCreated) {
+    : type_(type), cardMask_(0),
+      hash_(kZobrist.contractType[static_cast<int>(type)]), frontier_(0), roundCreated_(roundCreated) {
+    for (const auto& card : cards) {
+        cards_.push_back(card);
+        cardMask_ |= card.getMask();
+        hash_ ^= kZobrist.contractCard[card.getIndex()];
+    }
+    calculatePoints();
+}
+
+Contract::Contract(ContractType type, CardMask cards, int roundCreated)
+    : cardMask_(0), hash_(0), frontier_(0) {
+    reset(type, cards, roundCreated);
+}
+
+void Contract::reset(ContractType type, CardMask cards, int roundCreated) {
+    type_ = type;
+    cardMask_ = cards;
+    hash_ = kZobrist.contractType[static_cast<int>(type)];
+    roundCreated_ = roundCreated;
+    
+    // Rank order, so runs read naturally
+    cards_.clear();
+    for (int rank = 0; rank < kRanksPerSuit; ++rank) {
+        for (CardMask column = cards & rankColumn(rank); column; column &= column - 1) {
+            int index = lowestBitIndex(column);
+            cards_.push_back(Card::fromIndex(index));
+            hash_ ^= kZobrist.contractCard[index];
+        }
+    }
     calculatePoints();
 }
 
 void Contract::calculatePoints() {
     points_ = calculatePoints(type_, cards_.size());
+    frontier_ = calculateFrontier(type_, cardMask_);
 }
 
-int Contract::calculatePoints(ContractType type, int cardCount) {
+CardMask Contract::calculateFrontier(ContractType type, CardMask cards) {
+    int size = popCount(cards);
+    if (!cards || calculatePoints(type, size + 1) <= calculatePoints(type, size)) return 0;
+    
+    int first = lowestBitIndex(cards);
+    int suitBase = first / kRanksPerSuit * kRanksPerSuit;
+    std::uint32_t ranks = rankUnion(cards);
+    
+    CardMask frontier = 0;
     switch (type) {
         case ContractType::PARTNERSHIP:
-            switch (cardCount) {
-                case 3: return 3;
-                case 4: return 5;
-                case 5: return 8;
-                case 6: return 12;
-                case 7: return 18;
-                case 8: return 22;
-                case 9: return 27;
-                default: return 0;
-            }
-        case ContractType::TRADE_ROUTE:
-            switch (cardCount) {
-                case 3: return 4;
-                case 4: return 6;
-                case 5: return 10;
-                case 6: return 15;
-                case 7: return 22;
-                default: return 0;
-            }
+            frontier = (CardMask(kLaneMask) << suitBase) & ~cards;
+            break;
         case ContractType::MONOPOLY:
-            switch (cardCount) {
-                case 3: return 5;
-                case 4: return 12;
-                default: return 0;
-            }
+            frontier = rankColumn(first % kRanksPerSuit) & ~cards;
+            break;
         case ContractType::SILK_ROAD:
-            switch (cardCount) {
-                case 3: return 7;
-                case 4: return 11;
-                case 5: return 18;
-                case 6: return 27;
-                case 7: return 40;
-                default: return 0;
+        case ContractType::TRADE_ROUTE:
+            for (std::uint32_t missing = kLaneMask & ~ranks; missing; missing &= missing - 1) {
+                int rank = lowestBitIndex(missing);
+                if (!isRun(ranks | (1u << rank))) continue;
+                frontier |= (type == ContractType::SILK_ROAD)
+                    ? CardMask(1) << (suitBase + rank) : rankColumn(rank);
             }
+            break;
     }
-    return 0;
+    
+    // Every frontier card makes a contract of the same size, so one check covers
+    // the size limits
+    if (frontier && !isValidContract(type, cards | (frontier & -frontier))) {
+        frontier = 0;
+    }
+    return frontier;
+}
+
+int Contract::calculatePoints(ContractType type, int cardCount) {
+    if (cardCount < 0 || cardCount > kMaxContractCards) return 0;
+    return kPointsTable[static_cast<int>(type)][cardCount];
 }
 
-int Contract::getSupplyBonus() const {
-    if (type_ == ContractType::PARTNERSHIP || type_ == ContractType::SILK_ROAD) {
-        int size = cards_.size();
+int Contract::getSupplyBonus(ContractType type, int size) {
+    if (type == ContractType::PARTNERSHIP || type == ContractType::SILK_ROAD) {
         if (size >= 3 && size <= 5) return 1;
         if (size >= 6 && size <= 7) return 2;
         if (size >= 8) return 3;
@@ -63,25 +136,27 @@ int Contract::getSupplyBonus() const {
     return 0;
 }
 
-bool Contract::hasTradeRights() const {
-    return type_ == ContractType::TRADE_ROUTE || type_ == ContractType::SILK_ROAD;
+bool Contract::hasTradeRights(ContractType type) {
+    return type == ContractType::TRADE_ROUTE || type == ContractType::SILK_ROAD;
 }
 
-int Contract::getTradeCost() const {
-    if (!hasTradeRights()) return 0;
-    return (cards_.size() == 3) ? 2 : 1;
+int Contract::getTradeCost(ContractType type, int size) {
+    if (!hasTradeRights(type)) return 0;
+    return (size == 3) ? 2 : 1;
 }
 
-int Contract::getBonusDeals() const {
-    if (type_ == ContractType::MONOPOLY) {
-        if (cards_.size() == 3) return 1;
-        if (cards_.size() == 4) return 999; // Unlimited
+int Contract::getBonusDeals(ContractType type, int size) {
+    if (type == ContractType::MONOPOLY) {
+        if (size == 3) return 1;
+        if (size == 4) return 999; // Unlimited
     }
     return 0;
 }
 
-void Contract::addCards(const std::vector<Card>& newCards) {
-    cards_.insert(cards_.end(), newCards.begin(), newCards.end());
+void Contract::addCard(const Card& card) {
+    cards_.push_back(card);
+    cardMask_ |= card.getMask();
+    hash_ ^= kZobrist.contractCard[card.getIndex()];
     calculatePoints();
 }
 
@@ -89,7 +164,7 @@ std::string Contract::toString() const {
     std::ostringstream oss;
     oss << getTypeString() << " (" << cards_.size() << " cards, " 
         << points_ << " pts, Round " << roundCreated_ << "): ";
-    for (size_t i = 0; i < cards_.size(); ++i) {
+    for (int i = 0; i < cards_.size(); ++i) {
         if (i > 0) oss << ", ";
         oss << cards_[i].toString();
     }
@@ -100,116 +175,66 @@ std::string Contract::getTypeString() const {
     return contractTypeToString(type_);
 }
 
+bool Contract::isRun(std::uint32_t rankMask) {
+    return (kRunTable[(rankMask & kLaneMask) / 64] >> (rankMask % 64)) & 1;
+}
+
 bool Contract::isValidContract(ContractType type, const std::vector<Card>& cards) {
-    if (cards.empty()) return false;
+    CardMask mask = 0;
+    for (const auto& card : cards) {
+        if (mask & card.getMask()) return false; // Same card twice
+        mask |= card.getMask();
+    }
+    return isValidContract(type, mask);
+}
+
+bool Contract::isValidContract(ContractType type, CardMask cards) {
+    int size = popCount(cards);
+    if (size < 3) return false;
     
     switch (type) {
         case ContractType::PARTNERSHIP: {
-            if (cards.size() < 3 || cards.size() > 7) return false;
-            Suit suit = cards[0].getSuit();
-            for (const auto& card : cards) {
-                if (card.getSuit() != suit) return false;
-            }
-            return true;
+            if (size > ContractUniverse::kMaxSize) return false;
+            int suit = lowestBitIndex(cards) / kRanksPerSuit;
+            return popCount(suitLane(cards, suit)) == size;
         }
         
         case ContractType::TRADE_ROUTE: {
-            if (cards.size() < 3 || cards.size() > 7) return false;
-            std::vector<int> ranks;
-            for (const auto& card : cards) {
-                ranks.push_back(card.getRankValue());
-            }
-            std::sort(ranks.begin(), ranks.end());
-            
-            // Check for duplicates
-            for (size_t i = 1; i < ranks.size(); ++i) {
-                if (ranks[i] == ranks[i-1]) return false;
-            }
-            
-            // Check for sequential
-            bool isSequential = true;
-            for (size_t i = 1; i < ranks.size(); ++i) {
-                if (ranks[i] != ranks[i-1] + 1) {
-                    isSequential = false;
-                    break;
-                }
-            }
-            
-            if (isSequential) return true;
-            
-            // Check for wrap-around (Q-K-A) - must be exactly these at the end
-            if (ranks.size() >= 3) {
-                if (ranks[0] == 1) { // Has an Ace
-                    // Check if the rest form Q-K at the end
-                    bool hasQK = true;
-                    for (size_t i = 1; i < ranks.size(); ++i) {
-                        if (ranks[i] != 11 + i) { // Should be 12 (Q), 13 (K)
-                            hasQK = false;
-                            break;
-                        }
-                    }
-                    if (hasQK && ranks[ranks.size()-1] == 13) return true;
-                }
-            }
-            
-            return false;
+            std::uint32_t ranks = rankUnion(cards);
+            // A repeated rank collapses in the union, so the counts differ
+            return popCount(ranks) == size && isRun(ranks);
         }
         
         case ContractType::MONOPOLY: {
-            if (cards.size() < 3 || cards.size() > 4) return false;
-            Rank rank = cards[0].getRank();
-            for (const auto& card : cards) {
-                if (card.getRank() != rank) return false;
-            }
-            return true;
+            if (size > 4) return false;
+            int rank = lowestBitIndex(cards) % kRanksPerSuit;
+            return (cards & ~rankColumn(rank)) == 0;
         }
         
         case ContractType::SILK_ROAD: {
-            if (cards.size() < 3 || cards.size() > 7) return false;
-            Suit suit = cards[0].getSuit();
-            std::vector<int> ranks;
-            for (const auto& card : cards) {
-                if (card.getSuit() != suit) return false;
-                ranks.push_back(card.getRankValue());
-            }
-            std::sort(ranks.begin(), ranks.end());
-            
-            // Check for duplicates
-            for (size_t i = 1; i < ranks.size(); ++i) {
-                if (ranks[i] == ranks[i-1]) return false;
-            }
-            
-            // Check for sequential
-            bool isSequential = true;
-            for (size_t i = 1; i < ranks.size(); ++i) {
-                if (ranks[i] != ranks[i-1] + 1) {
-                    isSequential = false;
-                    break;
-                }
-            }
-            
-            if (isSequential) return true;
-            
-            // Check for wrap-around (Q-K-A)
-            if (ranks.size() >= 3) {
-                if (ranks[0] == 1) { // Has an Ace
-                    bool hasQK = true;
-                    for (size_t i = 1; i < ranks.size(); ++i) {
-                        if (ranks[i] != 11 + i) {
-                            hasQK = false;
-                            break;
-                        }
-                    }
-                    if (hasQK && ranks[ranks.size()-1] == 13) return true;
-                }
-            }
-            
-            return false;
+            int suit = lowestBitIndex(cards) / kRanksPerSuit;
+            std::uint32_t lane = suitLane(cards, suit);
+            return popCount(lane) == size && isRun(lane);
         }
     }
     return false;
 }
 
+ContractPool::ContractPool() : used_(0) {
+    contracts_.reserve(kMaxContractsPerGame);
+}
+
+Contract& ContractPool::acquire(ContractType type, CardMask cards, int roundCreated) {
+    if (used_ < contracts_.size()) {
+        contracts_[used_].reset(type, cards, roundCreated);
+    } else if (contracts_.size() < contracts_.capacity()) {
+        contracts_.emplace_back(type, cards, roundCreated);
+    } else {
+        throw std::length_error("Contract pool exhausted");
+    }
+    return contracts_[used_++];
+}
+
 std::string contractTypeToString(ContractType type) {
     switch (type) {
         case ContractType::PARTNERSHIP: return "Partnership";
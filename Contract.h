@@ -2,6 +2,9 @@
 #define CONTRACT_H
 
 #include "Card.h"
+#include "ContractUniverse.h"
+#include "InlineVector.h"
+#include "Zobrist.h"
 #include <vector>
 #include <string>
 
@@ -12,39 +15,88 @@ enum class ContractType {
     SILK_ROAD     // Sequential same suit
 };
 
+// A game never holds more contracts than this: each one takes at least 3 of the 52 cards
+constexpr int kMaxContractsPerGame = kDeckSize / 3;
+
+// The points table runs to this many cards, past the largest valid contract
+constexpr int kMaxContractCards = 9;
+using ContractCards = InlineVector<Card, ContractUniverse::kMaxSize>;
+
 class Contract {
 public:
     Contract(ContractType type, const std::vector<Card>& cards, int roundCreated);
+    Contract(ContractType type, CardMask cards, int roundCreated);
+    
+    // Signed contracts only change through their owner, so nothing replaces one
+    Contract(const Contract&) = default;
+    Contract& operator=(const Contract&) = delete;
     
     ContractType getType() const { return type_; }
-    const std::vector<Card>& getCards() const { return cards_; }
+    const ContractCards& getCards() const { return cards_; }
+    CardMask getCardMask() const { return cardMask_; }
     int getPoints() const { return points_; }
     int getRoundCreated() const { return roundCreated_; }
     int getSize() const { return cards_.size(); }
     
-    // Benefits
-    int getSupplyBonus() const;  // For Partnerships and Silk Roads
-    bool hasTradeRights() const; // For Trade Routes and Silk Roads
-    int getTradeCost() const;    // Cards to give for Bazaar exchange
-    int getBonusDeals() const;   // For Monopolies
+    // Zobrist hash of the type and cards; see zobristPlaceContract for its owner
+    std::uint64_t getHash() const { return hash_; }
     
-    void addCards(const std::vector<Card>& newCards);
+    // Cards that would legally extend this contract and raise its points
+    CardMask getFrontier() const { return frontier_; }
+    
+    // Benefits
+    int getSupplyBonus() const { return getSupplyBonus(type_, getSize()); }  // For Partnerships and Silk Roads
+    bool hasTradeRights() const { return hasTradeRights(type_); }            // For Trade Routes and Silk Roads
+    int getTradeCost() const { return getTradeCost(type_, getSize()); }      // Cards to give for Bazaar exchange
+    int getBonusDeals() const { return getBonusDeals(type_, getSize()); }    // For Monopolies
     
     std::string toString() const;
     std::string getTypeString() const;
     
     static int calculatePoints(ContractType type, int cardCount);
+    static CardMask calculateFrontier(ContractType type, CardMask cards);
+    static int getSupplyBonus(ContractType type, int size);
+    static bool hasTradeRights(ContractType type);
+    static int getTradeCost(ContractType type, int size);
+    static int getBonusDeals(ContractType type, int size);
     static bool isValidContract(ContractType type, const std::vector<Card>& cards);
+    static bool isValidContract(ContractType type, CardMask cards);
+    static bool isRun(std::uint32_t rankMask);  // 3-7 sequential ranks, Q-K-A may wrap
     
 private:
+    // Extending goes through Player::extendContract, which keeps the owner's
+    // score ledger in step; reuse goes through ContractPool
+    friend class Player;
+    friend class ContractPool;
+    
     ContractType type_;
-    std::vector<Card> cards_;
+    ContractCards cards_;
+    CardMask cardMask_;
+    std::uint64_t hash_;
+    CardMask frontier_;
     int points_;
     int roundCreated_;
     
+    // Reuses this contract for a new contract
+    void reset(ContractType type, CardMask cards, int roundCreated);
+    void addCard(const Card& card);
     void calculatePoints();
 };
 
+// Per-game contract storage. Contracts never move once acquired, so players can
+// hold plain pointers to them; reset() recycles every slot without freeing it.
+class ContractPool {
+public:
+    ContractPool();
+    
+    Contract& acquire(ContractType type, CardMask cards, int roundCreated);
+    void reset() { used_ = 0; }
+    
+private:
+    std::vector<Contract> contracts_;
+    size_t used_;
+};
+
 std::string contractTypeToString(ContractType type);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "ContractUniverse.h"
+#include "Contract.h"
+
+namespace {
+
+ContractUniverse makeUniverse() {
+    ContractUniverse universe;
+
+    // Counting up visits every set in ascending order
+    for (std::uint32_t ranks = 0; ranks <= kLaneMask; ++ranks) {
+        if (Contract::isValidContract(ContractType::PARTNERSHIP, CardMask(ranks))) {
+            universe.partnerships[popCount(ranks)].push_back(static_cast<std::uint16_t>(ranks));
+        }
+    }
+
+    for (int start = 0; start < ContractUniverse::kWrapSlot; ++start) {
+        for (int size = ContractUniverse::kMinSize; size <= ContractUniverse::kMaxSize; ++size) {
+            std::uint32_t run = ((1u << size) - 1) << start;
+            if (run <= kLaneMask && Contract::isRun(run)) {
+                universe.runs[start].push_back(static_cast<std::uint16_t>(run));
+            }
+        }
+    }
+    universe.runs[ContractUniverse::kWrapSlot].push_back(static_cast<std::uint16_t>(
+        (1u << 0) | (1u << 11) | (1u << 12)));  // Q-K-A
+
+    for (std::uint32_t suits = 0; suits < (1u << kNumSuits); ++suits) {
+        if (popCount(suits) >= ContractUniverse::kMinSize) {
+            universe.monopolies[popCount(suits)].push_back(static_cast<std::uint8_t>(suits));
+        }
+    }
+    return universe;
+}
+
+}
+
+const ContractUniverse kContractUniverse = makeUniverse();
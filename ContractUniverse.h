@@ -0,0 +1,48 @@
+#ifndef CONTRACT_UNIVERSE_H
+#define CONTRACT_UNIVERSE_H
+
+#include "Card.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Every valid contract, enumerated once at startup and grouped by type and
+// size. Contracts are stored per lane rather than as 52-card masks, since every
+// one lives in a single lane: Partnerships and Silk Roads in one suit, Trade
+// Routes in a run of ranks, Monopolies in one rank. A shape matches a hand
+// when (shape & lane) == shape.
+//
+// Each list is in ascending numeric order, and every subset of a lane is
+// numerically no larger than the lane, so a scan can stop at the first shape
+// above it.
+struct ContractUniverse {
+    static constexpr int kMinSize = 3;
+    static constexpr int kMaxSize = 7;
+    static constexpr int kRunSlots = kRanksPerSuit - 1;  // Starts Ace..Jack, plus Q-K-A last
+    static constexpr int kWrapSlot = kRunSlots - 1;
+
+    // Partnerships: 13-bit rank sets of one suit, by size
+    std::array<std::vector<std::uint16_t>, kMaxSize + 1> partnerships;
+    // Silk Roads and Trade Routes: runs of ranks by starting slot, shortest first
+    std::array<std::vector<std::uint16_t>, kRunSlots> runs;
+    // Monopolies: 4-bit suit sets of one rank, by size
+    std::array<std::vector<std::uint8_t>, kNumSuits + 1> monopolies;
+};
+
+extern const ContractUniverse kContractUniverse;
+
+// The cards of a 13-bit rank set placed in one suit
+inline CardMask laneToMask(std::uint32_t ranks, int suit) {
+    return CardMask(ranks) << (suit * kRanksPerSuit);
+}
+
+// The cards of a 4-bit suit set placed at one rank
+inline CardMask suitsToMask(std::uint32_t suits, int rankIndex) {
+    CardMask cards = 0;
+    for (; suits; suits &= suits - 1) {
+        cards |= CardMask(1) << (lowestBitIndex(suits) * kRanksPerSuit + rankIndex);
+    }
+    return cards;
+}
+
+#endif
@@ -0,0 +1,184 @@
+#include "DuplicateMatch.h"
+#include "Game.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// Deals handed to a worker at a time
+constexpr long long kChunkSize = 16;
+
+struct SeatResult {
+    int points;
+    int margin;  // Over the best opponent
+    int won;
+};
+
+SeatResult seatResult(const Game& game, int seat) {
+    const auto& players = game.getPlayers();
+    int bestOther = 0;
+    for (size_t other = 0; other < players.size(); ++other) {
+        if ((int)other != seat) bestOther = std::max(bestOther, players[other].getTotalPoints());
+    }
+    int points = players[seat].getTotalPoints();
+    return {points, points - bestOther, &game.getWinner() == &players[seat] ? 1 : 0};
+}
+
+}
+
+double DuplicateResults::getMeanPointsDifference() const {
+    return rotations ? pointsDifference.getMean() / rotations : 0.0;
+}
+
+double DuplicateResults::getPointsStandardError() const {
+    if (!rotations || pointsDifference.getCount() < 2) return 0.0;
+    return std::sqrt(pointsDifference.getVariance() / pointsDifference.getCount()) / rotations;
+}
+
+double DuplicateResults::getGamesSavedFactor() const {
+    double error = getPointsStandardError();
+    if (error <= 0.0 || getGamesPlayed() == 0) return 0.0;
+    // n candidate and n baseline games give a difference with variance (vc + vb) / n
+    double independentGames = 2.0 * (candidatePoints.getVariance() + baselinePoints.getVariance()) / (error * error);
+    return independentGames / getGamesPlayed();
+}
+
+void DuplicateResults::merge(const DuplicateResults& other) {
+    deals += other.deals;
+    rotations = std::max(rotations, other.rotations);
+    candidatePoints.merge(other.candidatePoints);
+    baselinePoints.merge(other.baselinePoints);
+    pointsDifference.merge(other.pointsDifference);
+    marginDifference.merge(other.marginDifference);
+    winDifference.merge(other.winDifference);
+}
+
+std::string DuplicateResults::toString() const {
+    auto perGame = [&](const RunningStats& stats) {
+        double mean = rotations ? stats.getMean() / rotations : 0.0;
+        double error = (rotations && stats.getCount() > 1)
+            ? std::sqrt(stats.getVariance() / stats.getCount()) / rotations : 0.0;
+        std::ostringstream oss;
+        oss << std::showpos << std::fixed << std::setprecision(4) << mean
+            << std::noshowpos << " +/- " << 1.96 * error << " (95% CI)";
+        return oss.str();
+    };
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(4);
+    oss << "=== DUPLICATE MATCH ===\n";
+    oss << "Deals: " << deals << " x " << rotations << " seat rotations (" << getGamesPlayed() << " games)"
+        << (stoppedEarly ? ", stopping rule met" : "") << "\n";
+    oss << "\nPoints per game: candidate " << candidatePoints.getMean()
+        << ", greedy " << baselinePoints.getMean() << " (same deals and seats)\n";
+    oss << "\nCandidate minus greedy, per game:\n";
+    oss << "  Points:   " << perGame(pointsDifference) << "\n";
+    oss << "  Margin:   " << perGame(marginDifference) << "\n";
+    oss << "  Win rate: " << perGame(winDifference) << "\n";
+    if (sprtEffect != 0.0) {
+        oss << "SPRT, 0 against " << std::showpos << sprtEffect << std::noshowpos << " points: "
+            << (sprt == SprtDecision::ACCEPT_EFFECT ? "candidate has the edge"
+                : sprt == SprtDecision::ACCEPT_NULL ? "no edge" : "undecided") << "\n";
+    }
+    if (getGamesSavedFactor() > 0.0) {
+        oss << "\nIndependent games would need " << std::setprecision(1) << getGamesSavedFactor()
+            << "x as many games for the same points error\n";
+    }
+    return oss.str();
+}
+
+DuplicateMatch::DuplicateMatch(const DuplicateConfig& config) : config_(config) {}
+
+void DuplicateMatch::playDeal(long long deal, Game& game, Strategy& candidate, DuplicateResults& results) const {
+    int numPlayers = config_.numPlayers;
+    auto stream = static_cast<std::uint64_t>(deal);
+
+    for (int seat = 0; seat < numPlayers; ++seat) game.setStrategy(seat, nullptr);
+    game.reset(config_.masterSeed, stream);
+    game.play();
+    std::array<SeatResult, GameState::kMaxPlayers> baseline;
+    for (int seat = 0; seat < numPlayers; ++seat) baseline[seat] = seatResult(game, seat);
+
+    long long points = 0, margin = 0, wins = 0;
+    for (int seat = 0; seat < numPlayers; ++seat) {
+        if (seat > 0) game.setStrategy(seat - 1, nullptr);
+        game.setStrategy(seat, &candidate);
+        game.reset(config_.masterSeed, stream);
+        game.play();
+
+        SeatResult result = seatResult(game, seat);
+        points += result.points - baseline[seat].points;
+        margin += result.margin - baseline[seat].margin;
+        wins += result.won - baseline[seat].won;
+        results.candidatePoints.add(result.points);
+        results.baselinePoints.add(baseline[seat].points);
+    }
+
+    results.deals++;
+    results.pointsDifference.add(points);
+    results.marginDifference.add(margin);
+    results.winDifference.add(wins);
+}
+
+DuplicateResults DuplicateMatch::run() const {
+    int numThreads = config_.numThreads;
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    DuplicateResults empty;
+    empty.rotations = config_.numPlayers;
+    empty.sprtEffect = config_.stopping.sprtEffect;
+
+    const StoppingRule& rule = config_.stopping;
+    std::function<bool(const DuplicateResults&)> shouldStop;
+    if (rule.isActive()) {
+        shouldStop = [&](const DuplicateResults& results) {
+            if (results.deals < rule.minSamples) return false;
+            if (rule.targetError > 0.0 &&
+                confidenceHalfWidth(results.pointsDifference, results.rotations) <= rule.targetError) {
+                return true;
+            }
+            return sprtTest(results.pointsDifference, results.rotations, rule) != SprtDecision::CONTINUE;
+        };
+    }
+    ChunkSequencer<DuplicateResults> sequencer(empty, shouldStop);
+    std::atomic<long long> nextChunk(0);
+
+    auto worker = [&]() {
+        Game game(config_.numPlayers, config_.masterSeed);
+        std::unique_ptr<Strategy> candidate;
+        if (config_.candidateFactory) candidate = config_.candidateFactory();
+        Strategy& playing = candidate ? *candidate : GreedyStrategy::instance();
+
+        for (;;) {
+            long long chunk = nextChunk.fetch_add(1);
+            long long begin = chunk * kChunkSize;
+            if (begin >= config_.numDeals || chunk >= sequencer.getLimit()) break;
+            long long end = std::min(begin + kChunkSize, config_.numDeals);
+            DuplicateResults local = empty;
+            for (long long deal = begin; deal < end; ++deal) {
+                playDeal(deal, game, playing, local);
+            }
+            sequencer.submit(chunk, std::move(local));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    DuplicateResults total = sequencer.take();
+    total.stoppedEarly = sequencer.isStopped();
+    total.sprt = sprtTest(total.pointsDifference, total.rotations, rule);
+    return total;
+}
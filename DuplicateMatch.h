@@ -0,0 +1,74 @@
+#ifndef DUPLICATE_MATCH_H
+#define DUPLICATE_MATCH_H
+
+#include "Statistics.h"
+#include "Strategy.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+struct DuplicateConfig {
+    long long numDeals = 10000;
+    int numPlayers = 4;
+    int numThreads = 0;          // 0 = one per hardware thread
+    std::uint64_t masterSeed = 1;
+
+    // Called once per worker thread. The candidate takes each seat in turn
+    // while the greedy AI plays the others.
+    std::function<std::unique_ptr<Strategy>()> candidateFactory;
+
+    // Both tests are on the points difference per game; numDeals becomes a cap
+    StoppingRule stopping;
+};
+
+// Per-deal paired results. For each deal, a result is the candidate's score
+// in seat s minus the greedy seat-s score on the same deal. These are summed
+// over the seat rotations, so each deal is one integer sample.
+struct DuplicateResults {
+    long long deals = 0;
+    int rotations = 0;
+    bool stoppedEarly = false;
+    double sprtEffect = 0.0;                        // Effect tested, 0 = no test
+    SprtDecision sprt = SprtDecision::CONTINUE;
+
+    // One sample per deal and seat, for comparison with independent games
+    RunningStats candidatePoints;
+    RunningStats baselinePoints;
+
+    // One sample per deal, summed over rotations
+    RunningStats pointsDifference;
+    RunningStats marginDifference;  // Own points minus the best opponent's
+    RunningStats winDifference;
+
+    long long getGamesPlayed() const { return deals * (rotations + 1); }
+
+    // Mean edge per game and its standard error
+    double getMeanPointsDifference() const;
+    double getPointsStandardError() const;
+
+    // Games independent pairs would need for the same standard error, over games played
+    double getGamesSavedFactor() const;
+
+    void merge(const DuplicateResults& other);
+    std::string toString() const;
+};
+
+// Duplicate-deal comparison of one strategy against the greedy AI. Each deal
+// is played once with greedy in every seat, and once per seat with the
+// candidate in that seat. The shuffled deck comes from (masterSeed, deal),
+// so every game on a deal starts from the same cards. Luck of the deal and
+// of the seat cancels in the paired differences.
+class DuplicateMatch {
+public:
+    explicit DuplicateMatch(const DuplicateConfig& config);
+
+    DuplicateResults run() const;
+
+private:
+    DuplicateConfig config_;
+
+    void playDeal(long long deal, Game& game, Strategy& candidate, DuplicateResults& results) const;
+};
+
+#endif
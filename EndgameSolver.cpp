@@ -0,0 +1,165 @@
+#include "EndgameSolver.h"
+#include "Game.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+using Points = std::array<int, GameState::kMaxPlayers>;
+
+// Table entries hold one 16-bit final score per seat
+std::uint64_t packPoints(const Points& points) {
+    std::uint64_t packed = 0;
+    for (int seat = 0; seat < GameState::kMaxPlayers; ++seat) {
+        packed |= std::uint64_t(points[seat] & 0xFFFF) << (16 * seat);
+    }
+    return packed;
+}
+
+Points unpackPoints(std::uint64_t packed) {
+    Points points;
+    for (int seat = 0; seat < GameState::kMaxPlayers; ++seat) {
+        points[seat] = static_cast<int>((packed >> (16 * seat)) & 0xFFFF);
+    }
+    return points;
+}
+
+// Whether `seat` would rather end with `a` than `b`
+bool prefers(const Points& a, const Points& b, int seat, int numPlayers) {
+    int bestA = 0, bestB = 0;
+    for (int other = 0; other < numPlayers; ++other) {
+        if (other == seat) continue;
+        bestA = std::max(bestA, a[other]);
+        bestB = std::max(bestB, b[other]);
+    }
+    int marginA = a[seat] - bestA, marginB = b[seat] - bestB;
+    if (marginA != marginB) return marginA > marginB;
+    return a[seat] > b[seat];
+}
+
+// Every deal the seat to play could make next, holding first
+void legalDeals(const Player& player, std::vector<DealDecision>& deals) {
+    deals.clear();
+    deals.push_back(DealDecision::hold());
+
+    const auto& contracts = player.getContracts();
+    for (size_t i = 0; i < contracts.size(); ++i) {
+        for (CardMask cards = player.getHandMask() & contracts[i]->getFrontier(); cards; cards &= cards - 1) {
+            deals.push_back(DealDecision::extend(static_cast<int>(i), Card::fromIndex(lowestBitIndex(cards))));
+        }
+    }
+    for (const auto& candidate : player.findContractShapes()) {
+        deals.push_back(DealDecision::sign(candidate));
+    }
+}
+
+// One solve, run on a private copy of the game
+class EndgameSearch {
+public:
+    EndgameSearch(Game& game, TranspositionTable& table, long long maxNodes)
+        : game_(game), table_(table), maxNodes_(maxNodes), nodes_(0), aborted_(false) {}
+
+    Points dealNode(DealDecision* best);
+
+    long long getNodes() const { return nodes_; }
+    bool isAborted() const { return aborted_; }
+
+private:
+    Game& game_;
+    TranspositionTable& table_;
+    long long maxNodes_;
+    long long nodes_;
+    bool aborted_;
+
+    Points nextTurn();
+    Points finalPoints() const;
+};
+
+Points EndgameSearch::finalPoints() const {
+    Points points{};
+    const auto& players = game_.getPlayers();
+    for (size_t seat = 0; seat < players.size(); ++seat) {
+        points[seat] = players[seat].getTotalPoints();
+    }
+    return points;
+}
+
+// Closes the current turn; the supply and barter phases that follow have no choices
+Points EndgameSearch::nextTurn() {
+    game_.endTurn();
+    if (game_.isFinished()) return finalPoints();
+    game_.beginTurn();
+    return dealNode(nullptr);
+}
+
+Points EndgameSearch::dealNode(DealDecision* best) {
+    if (game_.getDealsRemaining() <= 0) return nextTurn();
+
+    std::uint64_t key = game_.getHash();
+    std::uint64_t stored;
+    if (!best && table_.probe(key, stored)) return unpackPoints(stored);
+
+    if (++nodes_ > maxNodes_) {
+        aborted_ = true;
+        return {};
+    }
+
+    int seat = game_.getCurrentSeat();
+    std::vector<DealDecision> deals;
+    legalDeals(game_.getPlayers()[seat], deals);
+
+    GameState position = game_.snapshot();
+    Points bestPoints{};
+    for (size_t i = 0; i < deals.size(); ++i) {
+        if (i > 0) game_.restore(position);
+
+        Points points;
+        if (deals[i].kind == DealDecision::Kind::HOLD) {
+            points = nextTurn();
+        } else {
+            game_.applyDeal(deals[i]);
+            points = dealNode(nullptr);
+        }
+        if (aborted_) return {};
+
+        if (i == 0 || prefers(points, bestPoints, seat, game_.getNumPlayers())) {
+            bestPoints = points;
+            if (best) *best = deals[i];
+        }
+    }
+
+    table_.store(key, packPoints(bestPoints));
+    return bestPoints;
+}
+
+}
+
+EndgameSolver::EndgameSolver(const EndgameConfig& config)
+    : config_(config), table_(config.tableBits) {}
+
+bool EndgameSolver::inRange(const Game& game) const {
+    return game.getSupplySize() <= config_.maxSupply;
+}
+
+EndgameResult EndgameSolver::solve(const Game& game) const {
+    Game scratch(game.snapshot());
+    EndgameSearch search(scratch, table_, config_.maxNodes);
+
+    EndgameResult result;
+    result.points = search.dealNode(&result.best);
+    result.solved = !search.isAborted();
+    result.nodes = search.getNodes();
+    if (!result.solved) result.best = DealDecision::hold();
+    return result;
+}
+
+EndgameStrategy::EndgameStrategy(const EndgameSolver& solver, Strategy& fallback)
+    : solver_(solver), fallback_(fallback) {}
+
+DealDecision EndgameStrategy::chooseDeal(const Game& game, const Player& player) {
+    if (solver_.inRange(game)) {
+        EndgameResult result = solver_.solve(game);
+        if (result.solved) return result.best;
+    }
+    return fallback_.chooseDeal(game, player);
+}
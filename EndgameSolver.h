@@ -0,0 +1,66 @@
+#ifndef ENDGAME_SOLVER_H
+#define ENDGAME_SOLVER_H
+
+#include "Strategy.h"
+#include "GameState.h"
+#include "TranspositionTable.h"
+#include <array>
+
+struct EndgameConfig {
+    int maxSupply = 2;               // Solve once the supply is down to this many cards
+    long long maxNodes = 200000;     // Deal positions searched before giving up on a solve
+    int tableBits = 20;
+};
+
+struct EndgameResult {
+    bool solved = false;             // False if the search ran past maxNodes
+    DealDecision best;               // Move for the seat to play
+    std::array<int, GameState::kMaxPlayers> points{};  // Final points by seat under best play
+    long long nodes = 0;
+};
+
+// Exact solver for the last stretch of a game. With the supply order and every
+// hand known, the rest of the game is deterministic apart from the deal choices,
+// so it searches every sign/extend/hold choice of every player to the end.
+// Each seat picks what maximizes its final margin over the best opponent,
+// then its own points (max^n). Barter exchanges follow the default
+// Strategy::chooseExchange. Signings come from Player::findContractShapes, one
+// card choice per contract shape.
+//
+// The solver sees hidden cards, so it is a ground truth to measure heuristics
+// against rather than a fair opponent. Solved positions go in a shared
+// TranspositionTable keyed by Game::getHash(), so one solver can serve every
+// game and thread.
+class EndgameSolver {
+public:
+    explicit EndgameSolver(const EndgameConfig& config = EndgameConfig());
+
+    bool inRange(const Game& game) const;
+
+    // `game` must be inside a deal phase, as it is when Strategy::chooseDeal is called
+    EndgameResult solve(const Game& game) const;
+
+    const EndgameConfig& getConfig() const { return config_; }
+
+    // Forgets every solved position; not safe while other threads are solving
+    void clear() { table_.clear(); }
+
+private:
+    EndgameConfig config_;
+    mutable TranspositionTable table_;
+};
+
+// Plays exactly once the solver is in range, and like `fallback` before that
+// or whenever a solve runs out of nodes
+class EndgameStrategy : public Strategy {
+public:
+    explicit EndgameStrategy(const EndgameSolver& solver, Strategy& fallback = GreedyStrategy::instance());
+
+    DealDecision chooseDeal(const Game& game, const Player& player) override;
+
+private:
+    const EndgameSolver& solver_;
+    Strategy& fallback_;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "EventSink.h"
+#include "Game.h"
+#include <iostream>
+
+namespace {
+
+constexpr std::streamoff kFlushThreshold = 64 * 1024;
+
+}
+
+TextEventSink::TextEventSink(std::ostream& out, bool interactive)
+    : out_(out), interactive_(interactive), inFinalRound_(false) {}
+
+TextEventSink::~TextEventSink() {
+    flush();
+}
+
+void TextEventSink::flush() {
+    out_ << buffer_.str();
+    out_.flush();
+    buffer_.str("");
+    buffer_.clear();
+}
+
+void TextEventSink::flushIfLarge() {
+    if (buffer_.tellp() >= kFlushThreshold) {
+        flush();
+    }
+}
+
+void TextEventSink::onGameStart(const GameStartEvent& event) {
+    inFinalRound_ = false;
+    buffer_ << "=== MERCHANT EMPIRE SIMULATION ===\n";
+    buffer_ << "Starting game with " << event.game.getNumPlayers() << " players\n";
+    buffer_ << "Supply: " << event.supplyRemaining << " cards remaining\n";
+    buffer_ << "\n";
+}
+
+void TextEventSink::onTurnStart(const TurnStartEvent& event) {
+    if (!event.finalRound) return;
+
+    if (!inFinalRound_) {
+        buffer_ << "\n=== FINAL ROUND ===\n";
+        inFinalRound_ = true;
+    }
+    buffer_ << "\n" << event.player.getName() << "'s final turn:\n";
+}
+
+void TextEventSink::onContractSigned(const ContractSignedEvent& event) {
+    buffer_ << "  Round " << event.round << ": "
+            << event.player.getName() << " signed "
+            << event.contract.getTypeString()
+            << " (" << event.contract.getSize() << " cards, "
+            << event.contract.getPoints() << " pts)\n";
+    flushIfLarge();
+}
+
+void TextEventSink::onContractExtended(const ContractExtendedEvent& event) {
+    buffer_ << "  Round " << event.round << ": "
+            << event.player.getName() << " extended "
+            << event.contract.getTypeString()
+            << " (now " << event.contract.getSize() << " cards, "
+            << event.contract.getPoints() << " pts)\n";
+    flushIfLarge();
+}
+
+void TextEventSink::onGameOver(const GameOverEvent& event) {
+    event.game.printResults(buffer_);
+    flush();
+
+    if (!interactive_) return;
+
+    char choice;
+    out_ << "\nView detailed vote breakdown? (y/n): " << std::flush;
+    if (std::cin >> choice && (choice == 'y' || choice == 'Y')) {
+        event.game.printVoteBreakdown(buffer_);
+        flush();
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef EVENT_SINK_H
+#define EVENT_SINK_H
+
+#include "Card.h"
+#include <ostream>
+#include <sstream>
+
+class Game;
+class Player;
+class Contract;
+
+// Events carry references into the live game; sinks must not keep them past the call
+struct GameStartEvent {
+    const Game& game;
+    int supplyRemaining;
+};
+
+struct TurnStartEvent {
+    int round;
+    const Player& player;
+    bool finalRound;
+};
+
+struct CardDrawnEvent {
+    int round;
+    const Player& player;
+    const Card& card;
+};
+
+struct BazaarExchangeEvent {
+    int round;
+    const Player& player;
+    CardMask given;     // Cards traded into the discard
+    const Card& taken;
+    int replacement;    // Card::getIndex() of the supply card that refilled the slot, or -1
+};
+
+struct ContractSignedEvent {
+    int round;
+    const Player& player;
+    const Contract& contract;
+};
+
+struct ContractExtendedEvent {
+    int round;
+    const Player& player;
+    const Contract& contract;
+    const Card& card;
+};
+
+struct GameOverEvent {
+    const Game& game;
+    int rounds;
+    const Player& winner;
+};
+
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+
+    virtual void onGameStart(const GameStartEvent&) {}
+    virtual void onTurnStart(const TurnStartEvent&) {}
+    virtual void onCardDrawn(const CardDrawnEvent&) {}
+    virtual void onBazaarExchange(const BazaarExchangeEvent&) {}
+    virtual void onContractSigned(const ContractSignedEvent&) {}
+    virtual void onContractExtended(const ContractExtendedEvent&) {}
+    virtual void onGameOver(const GameOverEvent&) {}
+};
+
+// Discards everything. A Game with no sink attached skips building events
+// altogether, which is what headless batch runs use.
+class NullEventSink final : public EventSink {
+};
+
+// Forwards every event to two sinks, first to second
+class TeeEventSink : public EventSink {
+public:
+    TeeEventSink(EventSink& first, EventSink& second) : first_(first), second_(second) {}
+
+    void onGameStart(const GameStartEvent& event) override { first_.onGameStart(event); second_.onGameStart(event); }
+    void onTurnStart(const TurnStartEvent& event) override { first_.onTurnStart(event); second_.onTurnStart(event); }
+    void onCardDrawn(const CardDrawnEvent& event) override { first_.onCardDrawn(event); second_.onCardDrawn(event); }
+    void onBazaarExchange(const BazaarExchangeEvent& event) override {
+        first_.onBazaarExchange(event);
+        second_.onBazaarExchange(event);
+    }
+    void onContractSigned(const ContractSignedEvent& event) override {
+        first_.onContractSigned(event);
+        second_.onContractSigned(event);
+    }
+    void onContractExtended(const ContractExtendedEvent& event) override {
+        first_.onContractExtended(event);
+        second_.onContractExtended(event);
+    }
+    void onGameOver(const GameOverEvent& event) override { first_.onGameOver(event); second_.onGameOver(event); }
+
+private:
+    EventSink& first_;
+    EventSink& second_;
+};
+
+// Formats events as the classic console log. Text is buffered and written
+// at game over (or once the buffer grows large) instead of flushing per line.
+class TextEventSink : public EventSink {
+public:
+    explicit TextEventSink(std::ostream& out, bool interactive = false);
+    ~TextEventSink() override;
+
+    // Interactive sinks ask on std::cin whether to print the vote breakdown
+    void setInteractive(bool interactive) { interactive_ = interactive; }
+    void flush();
+
+    void onGameStart(const GameStartEvent& event) override;
+    void onTurnStart(const TurnStartEvent& event) override;
+    void onContractSigned(const ContractSignedEvent& event) override;
+    void onContractExtended(const ContractExtendedEvent& event) override;
+    void onGameOver(const GameOverEvent& event) override;
+
+private:
+    std::ostream& out_;
+    bool interactive_;
+    bool inFinalRound_;
+    std::ostringstream buffer_;
+
+    void flushIfLarge();
+};
+
+#endif
@@ -1,48 +1,147 @@
 #include "Game.h"
-#include <iostream>
+#include "Profiler.h"
 #include <algorithm>
 #include <iomanip>
+#include <stdexcept>
 
-Game::Game(int numPlayers, unsigned int seed) 
-    : numPlayers_(numPlayers), currentRound_(0) {
+Game::Game(int numPlayers, std::uint64_t seed, std::uint64_t stream) 
+    : numPlayers_(numPlayers), currentRound_(0), currentSeat_(0), dealsRemaining_(0),
+      phase_(GamePhase::MAIN), sink_(nullptr), strategies_(numPlayers, nullptr),
+      seed_(0), stream_(0), initialDeck_{}, hash_(0) {
     
-    if (seed == 0) {
-        std::random_device rd;
-        rng_.seed(rd());
-    } else {
-        rng_.seed(seed);
+    if (numPlayers < 2 || numPlayers > GameState::kMaxPlayers) {
+        throw std::invalid_argument("A game needs 2 to 4 players");
     }
     
     // Create players
+    players_.reserve(numPlayers_);
     for (int i = 0; i < numPlayers_; ++i) {
-        players_.push_back(std::make_shared<Player>(i + 1));
+        players_.emplace_back(i + 1);
+    }
+    supply_.reserve(kDeckSize);
+    bazaar_.reserve(GameState::kBazaarSize);
+    
+    reset(seed, stream);
+}
+
+void Game::reset(std::uint64_t seed, std::uint64_t stream) {
+    rng_.seed(seed, stream);
+    seed_ = seed;
+    stream_ = stream;
+    currentRound_ = 0;
+    currentSeat_ = 0;
+    dealsRemaining_ = 0;
+    phase_ = GamePhase::MAIN;
+    contractPool_.reset();
+    for (auto& player : players_) {
+        player.setHand(0);
+        player.clearContracts();
     }
+    bazaar_.clear();
     
     initializeDeck();
     dealCards();
     setupBazaar();
 }
 
-void Game::initializeDeck() {
-    // Create standard 52-card deck (no jokers)
-    std::vector<Suit> suits = {Suit::HEARTS, Suit::DIAMONDS, Suit::CLUBS, Suit::SPADES};
-    std::vector<Rank> ranks = {
-        Rank::ACE, Rank::TWO, Rank::THREE, Rank::FOUR, Rank::FIVE, Rank::SIX,
-        Rank::SEVEN, Rank::EIGHT, Rank::NINE, Rank::TEN, Rank::JACK, Rank::QUEEN, Rank::KING
-    };
+Game::Game(const GameState& state)
+    : numPlayers_(state.numPlayers), currentRound_(0), currentSeat_(0), dealsRemaining_(0),
+      phase_(GamePhase::MAIN), sink_(nullptr), strategies_(state.numPlayers, nullptr),
+      seed_(0), stream_(0), initialDeck_{}, hash_(0) {
     
-    supply_.clear();
-    for (Suit suit : suits) {
-        for (Rank rank : ranks) {
-            supply_.push_back(Card(rank, suit));
+    players_.reserve(numPlayers_);
+    for (int i = 0; i < numPlayers_; ++i) {
+        players_.emplace_back(i + 1);
+    }
+    supply_.reserve(kDeckSize);
+    bazaar_.reserve(GameState::kBazaarSize);
+    restore(state);
+}
+
+GameState Game::snapshot() const {
+    GameState state;
+    state.numPlayers = static_cast<std::uint8_t>(numPlayers_);
+    state.round = static_cast<std::uint8_t>(currentRound_);
+    state.seat = static_cast<std::uint8_t>(currentSeat_);
+    state.dealsRemaining = static_cast<std::uint16_t>(dealsRemaining_);
+    state.phase = phase_;
+    state.rng = rng_;
+    
+    state.supplySize = static_cast<std::uint8_t>(supply_.size());
+    for (size_t i = 0; i < supply_.size(); ++i) {
+        state.supply[i] = static_cast<std::uint8_t>(supply_[i].getIndex());
+    }
+    state.bazaarSize = static_cast<std::uint8_t>(bazaar_.size());
+    for (size_t i = 0; i < bazaar_.size(); ++i) {
+        state.bazaar[i] = static_cast<std::uint8_t>(bazaar_[i].getIndex());
+    }
+    
+    for (int seat = 0; seat < numPlayers_; ++seat) {
+        const auto& player = players_[seat];
+        state.hands[seat] = player.getHandMask();
+        for (const auto& contract : player.getContracts()) {
+            state.contracts[state.numContracts++] = {
+                contract->getCardMask(),
+                static_cast<std::uint8_t>(contract->getType()),
+                static_cast<std::uint8_t>(seat),
+                static_cast<std::uint8_t>(contract->getRoundCreated())
+            };
         }
     }
+    return state;
+}
+
+void Game::restore(const GameState& state) {
+    if (state.numPlayers != numPlayers_) {
+        throw std::invalid_argument("Snapshot is for a different number of players");
+    }
+    currentRound_ = state.round;
+    currentSeat_ = state.seat;
+    dealsRemaining_ = state.dealsRemaining;
+    phase_ = state.phase;
+    rng_ = state.rng;
+    
+    hash_ = 0;
+    supply_.clear();
+    for (int i = 0; i < state.supplySize; ++i) {
+        supply_.push_back(Card::fromIndex(state.supply[i]));
+        hash_ ^= kZobrist.supply[i][state.supply[i]];
+    }
+    bazaar_.clear();
+    for (int i = 0; i < state.bazaarSize; ++i) {
+        bazaar_.push_back(Card::fromIndex(state.bazaar[i]));
+        hash_ ^= kZobrist.bazaar[state.bazaar[i]];
+    }
+    
+    contractPool_.reset();
+    for (int seat = 0; seat < numPlayers_; ++seat) {
+        players_[seat].setHand(state.hands[seat]);
+        players_[seat].clearContracts();
+    }
+    for (int i = 0; i < state.numContracts; ++i) {
+        const auto& record = state.contracts[i];
+        players_[record.owner].addContract(contractPool_.acquire(
+            static_cast<ContractType>(record.type), record.cards, record.roundCreated));
+    }
+}
+
+void Game::initializeDeck() {
+    // Create standard 52-card deck (no jokers), suit by suit from Ace to King
+    supply_.clear();
+    for (int index = 0; index < kDeckSize; ++index) {
+        supply_.push_back(Card::fromIndex(index));
+    }
     
     shuffleDeck(supply_);
+    hash_ = 0;
+    for (int i = 0; i < kDeckSize; ++i) {
+        initialDeck_[i] = static_cast<std::uint8_t>(supply_[i].getIndex());
+        hash_ ^= kZobrist.supply[i][initialDeck_[i]];
+    }
 }
 
 void Game::shuffleDeck(std::vector<Card>& deck) {
-    std::shuffle(deck.begin(), deck.end(), rng_);
+    rng_.shuffle(deck.begin(), deck.end());
 }
 
 void Game::dealCards() {
@@ -51,7 +150,7 @@ void Game::dealCards() {
     for (int i = 0; i < cardsPerPlayer; ++i) {
         for (auto& player : players_) {
             if (!supply_.empty()) {
-                player->addCard(drawFromSupply());
+                player.addCard(drawFromSupply());
             }
         }
     }
@@ -61,6 +160,7 @@ void Game::setupBazaar() {
     for (int i = 0; i < 5; ++i) {
         if (!supply_.empty()) {
             bazaar_.push_back(drawFromSupply());
+            hash_ ^= kZobrist.bazaar[bazaar_.back().getIndex()];
         }
     }
 }
@@ -70,6 +170,7 @@ Card Game::drawFromSupply() {
         throw std::runtime_error("Supply is empty!");
     }
     Card card = supply_.back();
+    hash_ ^= kZobrist.supply[supply_.size() - 1][card.getIndex()];
     supply_.pop_back();
     return card;
 }
@@ -79,6 +180,7 @@ Card Game::takeFromBazaar(int index) {
         throw std::out_of_range("Invalid bazaar index");
     }
     Card card = bazaar_[index];
+    hash_ ^= kZobrist.bazaar[card.getIndex()];
     replaceInBazaar(index);
     return card;
 }
@@ -86,225 +188,275 @@ Card Game::takeFromBazaar(int index) {
 void Game::replaceInBazaar(int index) {
     if (!supply_.empty()) {
         bazaar_[index] = drawFromSupply();
+        hash_ ^= kZobrist.bazaar[bazaar_[index].getIndex()];
     } else {
         bazaar_.erase(bazaar_.begin() + index);
     }
 }
 
 void Game::play() {
-    std::cout << "=== MERCHANT EMPIRE SIMULATION ===" << std::endl;
-    std::cout << "Starting game with " << numPlayers_ << " players" << std::endl;
-    std::cout << "Supply: " << supply_.size() << " cards remaining" << std::endl;
-    std::cout << std::endl;
+    if (sink_) sink_->onGameStart({*this, static_cast<int>(supply_.size())});
     
-    // Main game loop
-    while (!isGameOver()) {
-        currentRound_++;
-        
-        for (auto& player : players_) {
-            if (isGameOver()) break;
-            playTurn(player);
-        }
+    while (!isFinished()) {
+        playNextTurn();
     }
+    PROFILE_COUNT(GAMES, 1);
     
-    // Final round for remaining players
-    std::cout << "\n=== FINAL ROUND ===" << std::endl;
-    for (auto& player : players_) {
-        std::cout << "\n" << player->getName() << "'s final turn:" << std::endl;
-        // Players can still make deals with remaining cards
-        dealPhase(player);
+    if (sink_) sink_->onGameOver({*this, currentRound_, getWinner()});
+}
+
+void Game::playNextTurn() {
+    if (phase_ == GamePhase::OVER) return;
+    
+    beginTurn();
+    dealPhase(players_[currentSeat_]);
+    endTurn();
+}
+
+void Game::beginTurn() {
+    if (phase_ == GamePhase::OVER) return;
+    
+    // Once the supply runs out, the rest of the round is skipped and
+    // every player gets a final deal phase with their remaining cards
+    if (phase_ == GamePhase::MAIN && isGameOver()) {
+        phase_ = GamePhase::FINAL_ROUND;
+        currentSeat_ = 0;
     }
     
-    printResults();
+    auto& player = players_[currentSeat_];
+    if (phase_ == GamePhase::MAIN) {
+        if (currentSeat_ == 0) currentRound_++;
+        if (sink_) sink_->onTurnStart({currentRound_, player, false});
+        supplyPhase(player);
+        barterPhase(player);
+    } else {
+        if (sink_) sink_->onTurnStart({currentRound_, player, true});
+    }
+    dealsRemaining_ = player.getTotalDeals();
 }
 
-void Game::playTurn(std::shared_ptr<Player> player) {
-    supplyPhase(player);
-    //barterPhase(player);
-    dealPhase(player);
+void Game::endTurn() {
+    dealsRemaining_ = 0;
+    if (++currentSeat_ == numPlayers_) {
+        currentSeat_ = 0;
+        if (phase_ == GamePhase::FINAL_ROUND) phase_ = GamePhase::OVER;
+    }
 }
 
-void Game::supplyPhase(std::shared_ptr<Player> player) {
+void Game::setStrategy(int seat, Strategy* strategy) {
+    if (seat < 0 || seat >= numPlayers_) {
+        throw std::out_of_range("Invalid seat");
+    }
+    strategies_[seat] = strategy;
+}
+
+void Game::supplyPhase(Player& player) {
+    PROFILE_SCOPE(SUPPLY_PHASE);
+    
     // Base acquisition
     int cardsDrawn = 0;
     if (supply_.size() >= 1) {
-        player->addCard(drawFromSupply());
+        Card card = drawFromSupply();
+        player.addCard(card);
         cardsDrawn = 1;
+        if (sink_) sink_->onCardDrawn({currentRound_, player, card});
     } 
     
     // Supply agreements from partnerships
-    int supplyBonus = player->getTotalSupplyBonus();
+    int supplyBonus = player.getTotalSupplyBonus();
     for (int i = 0; i < supplyBonus && !supply_.empty(); ++i) {
-        player->addCard(drawFromSupply());
+        Card card = drawFromSupply();
+        player.addCard(card);
         cardsDrawn++;
+        if (sink_) sink_->onCardDrawn({currentRound_, player, card});
     }
 }
 
-void Game::barterPhase(std::shared_ptr<Player> player) {
-    auto tradeRoutes = player->getTradeRoutes();
+void Game::barterPhase(Player& player) {
+    PROFILE_SCOPE(BARTER_PHASE);
     
-    for (auto& route : tradeRoutes) {
-        if (bazaar_.empty() || player->getHandSize() < route->getTradeCost()) {
+    Strategy* strategy = strategies_[currentSeat_];
+    if (!strategy) strategy = &GreedyStrategy::instance();
+    
+    // Each trade-rights contract allows one exchange per turn
+    const auto& contracts = player.getContracts();
+    for (size_t i = 0; i < contracts.size(); ++i) {
+        const Contract& route = *contracts[i];
+        if (!route.hasTradeRights() || bazaar_.empty() || player.getHandSize() < route.getTradeCost()) {
             continue;
         }
         
-        // Simple strategy: take the highest rank card from bazaar
-        int bestIndex = 0;
-        int bestRank = bazaar_[0].getRankValue();
-        for (size_t i = 1; i < bazaar_.size(); ++i) {
-            if (bazaar_[i].getRankValue() > bestRank) {
-                bestRank = bazaar_[i].getRankValue();
-                bestIndex = i;
-            }
+        ExchangeDecision decision = strategy->chooseExchange(*this, player, route);
+        if (!decision.trade) {
+            continue;
         }
-        
-        // Trade away low-value cards
-        auto cardsToTrade = player->selectCardsForTrade(route->getTradeCost(), bazaar_);
-        for (const auto& card : cardsToTrade) {
-            player->removeCard(card);
+        if (decision.bazaarIndex < 0 || decision.bazaarIndex >= (int)bazaar_.size()) {
+            throw std::out_of_range("Invalid bazaar index");
+        }
+        if (popCount(decision.give) != route.getTradeCost() ||
+            (decision.give & player.getHandMask()) != decision.give) {
+            throw std::invalid_argument("Illegal bazaar exchange");
         }
         
-        // Take from bazaar
-        Card takenCard = takeFromBazaar(bestIndex);
-        player->addCard(takenCard);
+        // Given cards leave the game; the taken slot is refilled from the supply
+        player.removeCards(decision.give);
+        size_t bazaarSize = bazaar_.size();
+        Card takenCard = takeFromBazaar(decision.bazaarIndex);
+        player.addCard(takenCard);
+        
+        if (sink_) {
+            int replacement = bazaar_.size() == bazaarSize ? bazaar_[decision.bazaarIndex].getIndex() : -1;
+            sink_->onBazaarExchange({currentRound_, player, decision.give, takenCard, replacement});
+        }
     }
 }
 
-void Game::dealPhase(std::shared_ptr<Player> player) {
-    int availableDeals = player->getTotalDeals();
+void Game::dealPhase(Player& player) {
+    PROFILE_SCOPE(DEAL_PHASE);
     
-    for (int dealNum = 0; dealNum < availableDeals; ++dealNum) {
-        auto bestContract = player->selectBestContract();
-        
-        if (bestContract.points == 0 || bestContract.cards.empty()) {
-            break; // No valid contracts to make
+    Strategy* strategy = strategies_[currentSeat_];
+    if (!strategy) strategy = &GreedyStrategy::instance();
+    
+    while (dealsRemaining_ > 0) {
+        DealDecision decision = strategy->chooseDeal(*this, player);
+        if (decision.kind == DealDecision::Kind::HOLD) {
+            break;
         }
-        
-        // Check if we should extend an existing contract instead
-        bool extended = false;
-        for (auto& existingContract : player->getContracts()) {
-            for (const auto& card : bestContract.cards) {
-                if (player->shouldExtendContract(existingContract, card)) {
-                    existingContract->addCards({card});
-                    player->removeCard(card);
-                    extended = true;
-                    
-                    std::cout << "  Round " << currentRound_ << ": " 
-                              << player->getName() << " extended " 
-                              << existingContract->getTypeString() 
-                              << " (now " << existingContract->getSize() << " cards, "
-                              << existingContract->getPoints() << " pts)" << std::endl;
-                    break;
-                }
-            }
-            if (extended) break;
+        applyDeal(decision);
+    }
+    dealsRemaining_ = 0;
+}
+
+void Game::applyDeal(const DealDecision& decision) {
+    Player& player = players_[currentSeat_];
+    
+    if (decision.kind == DealDecision::Kind::EXTEND) {
+        const auto& contracts = player.getContracts();
+        if (decision.contractIndex < 0 || decision.contractIndex >= (int)contracts.size()) {
+            throw std::out_of_range("Invalid contract index");
+        }
+        Contract& existingContract = *contracts[decision.contractIndex];
+        Card card = Card::fromIndex(decision.cardIndex);
+        if (!player.hasCard(card) || !player.shouldExtendContract(existingContract, card)) {
+            throw std::invalid_argument("Illegal contract extension");
         }
         
-        if (!extended) {
-            // Create new contract
-            auto newContract = std::make_shared<Contract>(
-                bestContract.type, bestContract.cards, currentRound_
-            );
-            player->addContract(newContract);
-            
-            // Remove cards from hand
-            for (const auto& card : bestContract.cards) {
-                player->removeCard(card);
-            }
-            
-            std::cout << "  Round " << currentRound_ << ": " 
-                      << player->getName() << " signed " 
-                      << newContract->getTypeString() 
-                      << " (" << newContract->getSize() << " cards, "
-                      << newContract->getPoints() << " pts)" << std::endl;
+        player.extendContract(decision.contractIndex, card);
+        dealsRemaining_--;
+        PROFILE_COUNT(CONTRACTS_EXTENDED, 1);
+        
+        if (sink_) sink_->onContractExtended({currentRound_, player, existingContract, card});
+    } else if (decision.kind == DealDecision::Kind::SIGN) {
+        if ((decision.cards & player.getHandMask()) != decision.cards) {
+            throw std::invalid_argument("Contract uses a card not in hand");
+        }
+        if (!Contract::isValidContract(decision.type, decision.cards)) {
+            throw std::invalid_argument("Illegal contract");
         }
+        
+        // Create new contract
+        Contract& newContract = contractPool_.acquire(decision.type, decision.cards, currentRound_);
+        player.addContract(newContract);
+        
+        // Remove cards from hand
+        player.removeCards(decision.cards);
+        dealsRemaining_--;
+        PROFILE_COUNT(CONTRACTS_SIGNED, 1);
+        
+        if (sink_) sink_->onContractSigned({currentRound_, player, newContract});
     }
 }
 
-std::shared_ptr<Player> Game::getWinner() const {
-    auto winner = players_[0];
+std::uint64_t Game::getHash() const {
+    std::uint64_t hash = hash_ ^ kZobrist.seat[currentSeat_] ^ kZobrist.phase[static_cast<int>(phase_)];
+    for (const auto& player : players_) {
+        hash ^= player.getHash();
+    }
+    // Four-card monopolies make the deal count unbounded, so it is mixed in rather than keyed
+    return hash ^ splitMix64(static_cast<std::uint64_t>(dealsRemaining_));
+}
+
+const Player& Game::getWinner() const {
+    const Player* winner = &players_[0];
     int maxPoints = winner->getTotalPoints();
     
     for (size_t i = 1; i < players_.size(); ++i) {
-        int points = players_[i]->getTotalPoints();
+        int points = players_[i].getTotalPoints();
         if (points > maxPoints) {
             maxPoints = points;
-            winner = players_[i];
+            winner = &players_[i];
         } else if (points == maxPoints) {
             // Tiebreaker: most contracts
-            if (players_[i]->getContracts().size() > winner->getContracts().size()) {
-                winner = players_[i];
+            if (players_[i].getContracts().size() > winner->getContracts().size()) {
+                winner = &players_[i];
             }
         }
     }
     
-    return winner;
+    return *winner;
 }
 
-void Game::printResults() const {
-    std::cout << "\n\n=== GAME OVER ===" << std::endl;
-    std::cout << "Total Rounds: " << currentRound_ << std::endl;
-    std::cout << "\n=== FINAL STANDINGS ===" << std::endl;
-    
+std::vector<const Player*> Game::getStandings() const {
     // Sort players by points
-    std::vector<std::shared_ptr<Player>> sortedPlayers = players_;
+    std::vector<const Player*> sortedPlayers;
+    for (const auto& player : players_) {
+        sortedPlayers.push_back(&player);
+    }
     std::sort(sortedPlayers.begin(), sortedPlayers.end(),
-        [](const std::shared_ptr<Player>& a, const std::shared_ptr<Player>& b) {
+        [](const Player* a, const Player* b) {
             int pointsA = a->getTotalPoints();
             int pointsB = b->getTotalPoints();
             if (pointsA != pointsB) return pointsA > pointsB;
             return a->getContracts().size() > b->getContracts().size();
         });
+    return sortedPlayers;
+}
+
+void Game::printResults(std::ostream& out) const {
+    out << "\n\n=== GAME OVER ===\n";
+    out << "Total Rounds: " << currentRound_ << "\n";
+    out << "\n=== FINAL STANDINGS ===\n";
     
+    auto sortedPlayers = getStandings();
     for (size_t i = 0; i < sortedPlayers.size(); ++i) {
         auto player = sortedPlayers[i];
-        std::cout << "\n" << (i + 1) << ". " << player->getName() 
-                  << " - " << player->getTotalPoints() << " points"
-                  << " (" << player->getContracts().size() << " contracts)" << std::endl;
+        out << "\n" << (i + 1) << ". " << player->getName() 
+            << " - " << player->getTotalPoints() << " points"
+            << " (" << player->getContracts().size() << " contracts)\n";
         
-        std::cout << "   Contracts:" << std::endl;
+        out << "   Contracts:\n";
         for (const auto& contract : player->getContracts()) {
-            std::cout << "   - " << contract->toString() << std::endl;
+            out << "   - " << contract->toString() << "\n";
         }
     }
 
     auto winner = sortedPlayers[0];
-    std::cout << "\n*** WINNER: " << winner->getName()
-              << " with " << winner->getTotalPoints() << " points! ***" << std::endl;
-
-    char choice;
-    std::cout << "\nView detailed vote breakdown? (y/n): ";
-    if (std::cin >> choice && (choice == 'y' || choice == 'Y')) {
-        printVoteBreakdown(sortedPlayers);
-    }
+    out << "\n*** WINNER: " << winner->getName()
+        << " with " << winner->getTotalPoints() << " points! ***\n";
 }
 
-void Game::printVoteBreakdown(const std::vector<std::shared_ptr<Player>>& sortedPlayers) const {
-    std::cout << "\n=== VOTE BREAKDOWN ===" << std::endl;
+void Game::printVoteBreakdown(std::ostream& out) const {
+    out << "\n=== VOTE BREAKDOWN ===\n";
 
     std::vector<Suit> suits = {Suit::HEARTS, Suit::DIAMONDS, Suit::CLUBS, Suit::SPADES};
 
-    for (const auto& player : sortedPlayers) {
-        auto breakdown = player->calculateVoteBreakdown();
+    for (const auto& player : getStandings()) {
+        const auto& breakdown = player->getVoteBreakdown();
 
-        std::cout << "\n" << player->getName() << ":" << std::endl;
-        std::cout << "  Guild Standing Votes by Suit:" << std::endl;
+        out << "\n" << player->getName() << ":\n";
+        out << "  Guild Standing Votes by Suit:\n";
 
         int totalGuildStanding = 0;
         for (auto suit : suits) {
-            int votes = 0;
-            auto it = breakdown.guildStanding.find(suit);
-            if (it != breakdown.guildStanding.end()) {
-                votes = it->second;
-            }
+            int votes = breakdown.guildStanding[static_cast<int>(suit)];
             totalGuildStanding += votes;
-            std::cout << "    " << suitToString(suit) << ": " << votes << std::endl;
+            out << "    " << suitToString(suit) << ": " << votes << "\n";
         }
 
-        std::cout << "    Total Guild Standing Votes: " << totalGuildStanding << std::endl;
-        std::cout << "  Caravan Capacity Votes: " << breakdown.caravanCapacity << std::endl;
-        std::cout << "  Market Share Votes: " << breakdown.marketShare << std::endl;
-        std::cout << "  Silk Road Marks (+1 each qualifying contract): "
-                  << breakdown.silkRoadMarks << std::endl;
+        out << "    Total Guild Standing Votes: " << totalGuildStanding << "\n";
+        out << "  Caravan Capacity Votes: " << breakdown.caravanCapacity << "\n";
+        out << "  Market Share Votes: " << breakdown.marketShare << "\n";
+        out << "  Silk Road Marks (+1 each qualifying contract): "
+            << breakdown.silkRoadMarks << "\n";
     }
 }
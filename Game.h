@@ -4,24 +4,92 @@
 #include "Card.h"
 #include "Contract.h"
 #include "Player.h"
+#include "EventSink.h"
+#include "GameState.h"
+#include "Strategy.h"
+#include "Rng.h"
+#include "Zobrist.h"
+#include <array>
+#include <cstdint>
+#include <ostream>
 #include <vector>
-#include <memory>
-#include <random>
 
 class Game {
 public:
-    Game(int numPlayers = 4, unsigned int seed = 0);
+    // The same (seed, stream) always deals the same game; a batch plays game i as stream i
+    Game(int numPlayers = 4, std::uint64_t seed = 0, std::uint64_t stream = 0);
+    explicit Game(const GameState& state);
+    
+    // Players hold pointers into this game's contract pool
+    Game(const Game&) = delete;
+    Game& operator=(const Game&) = delete;
+    Game(Game&&) = default;
+    Game& operator=(Game&&) = default;
+    
+    // Starts a new game in place, keeping strategies, sink and all storage
+    void reset(std::uint64_t seed, std::uint64_t stream = 0);
     
     void play();
-    void printResults() const;
+    void playNextTurn();
+    bool isFinished() const { return phase_ == GamePhase::OVER; }
+    GamePhase getPhase() const { return phase_; }
+    
+    // Strategies are not owned; seats without one play GreedyStrategy
+    void setStrategy(int seat, Strategy* strategy);
+    
+    // Mid-turn stepping for search: beginTurn() plays the supply and barter
+    // phases and opens the deal phase, applyDeal() makes one deal for the
+    // current seat, and endTurn() closes the turn once the deal phase is over
+    void beginTurn();
+    void applyDeal(const DealDecision& decision);
+    void endTurn();
+    int getDealsRemaining() const { return dealsRemaining_; }
+    
+    // Snapshots are plain values; restore() reuses this game's storage
+    GameState snapshot() const;
+    void restore(const GameState& state);
+    void printResults(std::ostream& out) const;
+    
+    // Zobrist hash of everything that decides how the game goes on: card
+    // locations, seat, phase and deals left. Equal positions hash equally no
+    // matter how they were reached; the round number and RNG are left out.
+    std::uint64_t getHash() const;
+    void printVoteBreakdown(std::ostream& out) const;
+    
+    // Events go to the sink; with none attached (the default) nothing is built or printed
+    void setEventSink(EventSink* sink) { sink_ = sink; }
+    
+    int getNumPlayers() const { return numPlayers_; }
+    int getCurrentRound() const { return currentRound_; }
+    int getCurrentSeat() const { return currentSeat_; }
+    int getSupplySize() const { return static_cast<int>(supply_.size()); }
+    const std::vector<Card>& getBazaar() const { return bazaar_; }
+    
+    // What the last reset() dealt from; a restored game keeps these unchanged
+    std::uint64_t getSeed() const { return seed_; }
+    std::uint64_t getStream() const { return stream_; }
+    const std::array<std::uint8_t, kDeckSize>& getInitialDeck() const { return initialDeck_; }
+    const std::vector<Player>& getPlayers() const { return players_; }
+    const Player& getWinner() const;
+    std::vector<const Player*> getStandings() const;
     
 private:
     int numPlayers_;
     int currentRound_;
-    std::vector<std::shared_ptr<Player>> players_;
+    int currentSeat_;
+    int dealsRemaining_;
+    GamePhase phase_;
+    EventSink* sink_;
+    std::vector<Strategy*> strategies_;
+    std::vector<Player> players_;
+    ContractPool contractPool_;
     std::vector<Card> supply_;
     std::vector<Card> bazaar_;
-    std::mt19937 rng_;
+    Rng rng_;
+    std::uint64_t seed_;
+    std::uint64_t stream_;
+    std::array<std::uint8_t, kDeckSize> initialDeck_;  // Shuffled order, top card last
+    std::uint64_t hash_;  // Supply and bazaar part of getHash(), kept up to date per card
     
     // Setup
     void initializeDeck();
@@ -30,22 +98,18 @@ private:
     void shuffleDeck(std::vector<Card>& deck);
     
     // Turn phases
-    void playTurn(std::shared_ptr<Player> player);
-    void supplyPhase(std::shared_ptr<Player> player);
-    void barterPhase(std::shared_ptr<Player> player);
-    void dealPhase(std::shared_ptr<Player> player);
+    void supplyPhase(Player& player);
+    void barterPhase(Player& player);
+    void dealPhase(Player& player);
     
     // Helper methods
     Card drawFromSupply();
     Card takeFromBazaar(int index);
     void replaceInBazaar(int index);
     bool isGameOver() const { return supply_.empty(); }
-    
-    std::shared_ptr<Player> getWinner() const;
 
     void printGameState() const;
-    void printPlayerState(const std::shared_ptr<Player>& player) const;
-    void printVoteBreakdown(const std::vector<std::shared_ptr<Player>>& sortedPlayers) const;
+    void printPlayerState(const Player& player) const;
 };
 
 #endif
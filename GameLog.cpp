@@ -0,0 +1,350 @@
+#include "GameLog.h"
+#include "Game.h"
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kFileMagic[8] = {'M', 'E', 'M', 'P', 'L', 'O', 'G', '\0'};
+constexpr std::uint32_t kFileVersion = 2;  // 2: 16-bit final points
+
+// Finished games are handed to the writer once this much has built up
+constexpr size_t kFlushThreshold = 1 << 20;
+
+constexpr CardMask kDeckMask = (CardMask(1) << kDeckSize) - 1;
+constexpr int kNumContractTypes = 4;
+
+bool isCard(std::uint8_t index) {
+    return index < kDeckSize;
+}
+
+std::uint8_t seatOf(const Player& player) {
+    return static_cast<std::uint8_t>(player.getId() - 1);
+}
+
+}
+
+GameLogWriter::GameLogWriter(const std::string& path)
+    : file_(std::fopen(path.c_str(), "wb")), failed_(false) {
+    if (!file_) {
+        throw std::runtime_error("Cannot open game log " + path);
+    }
+    LogFileHeader header{};
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version = kFileVersion;
+    header.gameHeaderSize = sizeof(LogGameHeader);
+    header.recordSize = sizeof(LogRecord);
+    append(reinterpret_cast<const unsigned char*>(&header), sizeof(header));
+}
+
+GameLogWriter::~GameLogWriter() {
+    std::fclose(file_);
+}
+
+void GameLogWriter::append(const unsigned char* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!failed_ && std::fwrite(data, 1, size, file_) != size) {
+        failed_ = true;
+    }
+}
+
+bool GameLogWriter::finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!failed_ && std::fflush(file_) != 0) {
+        failed_ = true;
+    }
+    return !failed_;
+}
+
+GameLogSink::GameLogSink(GameLogWriter& writer) : writer_(writer), header_{} {
+    records_.reserve(64);
+    buffer_.reserve(kFlushThreshold + 4096);
+}
+
+GameLogSink::~GameLogSink() {
+    flush();
+}
+
+void GameLogSink::flush() {
+    if (buffer_.empty()) return;
+    writer_.append(buffer_.data(), buffer_.size());
+    buffer_.clear();
+}
+
+LogRecord& GameLogSink::addRecord(LogRecordType type, int round, const Player& player) {
+    records_.emplace_back();
+    LogRecord& record = records_.back();
+    record = LogRecord{};
+    record.type = static_cast<std::uint8_t>(type);
+    record.round = static_cast<std::uint8_t>(round);
+    record.seat = seatOf(player);
+    record.card = LogRecord::kNoCard;
+    record.extra = LogRecord::kNoCard;
+    return record;
+}
+
+void GameLogSink::onGameStart(const GameStartEvent& event) {
+    const Game& game = event.game;
+    header_ = LogGameHeader{};
+    header_.magic = LogGameHeader::kMagic;
+    header_.seed = game.getSeed();
+    header_.stream = game.getStream();
+    header_.numPlayers = static_cast<std::uint8_t>(game.getNumPlayers());
+    std::memcpy(header_.deck, game.getInitialDeck().data(), kDeckSize);
+
+    records_.clear();
+    for (const auto& player : game.getPlayers()) {
+        addRecord(LogRecordType::DEAL, 0, player).cards = player.getHandMask();
+    }
+    // One record per slot, so the bazaar's order survives
+    for (const auto& card : game.getBazaar()) {
+        LogRecord& record = addRecord(LogRecordType::BAZAAR, 0, game.getPlayers()[0]);
+        record.cards = card.getMask();
+        record.card = static_cast<std::uint8_t>(card.getIndex());
+    }
+}
+
+void GameLogSink::onCardDrawn(const CardDrawnEvent& event) {
+    LogRecord& record = addRecord(LogRecordType::DRAW, event.round, event.player);
+    record.cards = event.card.getMask();
+    record.card = static_cast<std::uint8_t>(event.card.getIndex());
+}
+
+void GameLogSink::onBazaarExchange(const BazaarExchangeEvent& event) {
+    LogRecord& record = addRecord(LogRecordType::EXCHANGE, event.round, event.player);
+    record.cards = event.given;
+    record.card = static_cast<std::uint8_t>(event.taken.getIndex());
+    if (event.replacement >= 0) {
+        record.extra = static_cast<std::uint8_t>(event.replacement);
+    }
+}
+
+void GameLogSink::onContractSigned(const ContractSignedEvent& event) {
+    LogRecord& record = addRecord(LogRecordType::SIGN, event.round, event.player);
+    record.cards = event.contract.getCardMask();
+    record.contractType = static_cast<std::uint8_t>(event.contract.getType());
+    record.contractIndex = static_cast<std::uint8_t>(event.player.getContracts().size() - 1);
+}
+
+void GameLogSink::onContractExtended(const ContractExtendedEvent& event) {
+    LogRecord& record = addRecord(LogRecordType::EXTEND, event.round, event.player);
+    record.cards = event.card.getMask();
+    record.card = static_cast<std::uint8_t>(event.card.getIndex());
+    record.contractType = static_cast<std::uint8_t>(event.contract.getType());
+
+    const auto& contracts = event.player.getContracts();
+    for (size_t i = 0; i < contracts.size(); ++i) {
+        if (contracts[i] == &event.contract) {
+            record.contractIndex = static_cast<std::uint8_t>(i);
+            break;
+        }
+    }
+}
+
+void GameLogSink::onGameOver(const GameOverEvent& event) {
+    header_.rounds = static_cast<std::uint8_t>(event.rounds);
+    header_.winner = seatOf(event.winner);
+    const auto& players = event.game.getPlayers();
+    for (size_t seat = 0; seat < players.size(); ++seat) {
+        header_.points[seat] = static_cast<std::uint16_t>(players[seat].getTotalPoints());
+    }
+    header_.recordCount = static_cast<std::uint32_t>(records_.size());
+
+    auto headerBytes = reinterpret_cast<const unsigned char*>(&header_);
+    auto recordBytes = reinterpret_cast<const unsigned char*>(records_.data());
+    buffer_.insert(buffer_.end(), headerBytes, headerBytes + sizeof(header_));
+    buffer_.insert(buffer_.end(), recordBytes, recordBytes + records_.size() * sizeof(LogRecord));
+    records_.clear();
+
+    if (buffer_.size() >= kFlushThreshold) {
+        flush();
+    }
+}
+
+void LoggedGame::check() const {
+    if (header->numPlayers < 2 || header->numPlayers > GameState::kMaxPlayers
+        || header->winner >= header->numPlayers) {
+        throw std::runtime_error("Corrupt game header in log");
+    }
+    for (std::uint8_t card : header->deck) {
+        if (!isCard(card)) throw std::runtime_error("Corrupt game header in log");
+    }
+    for (const LogRecord& record : *this) {
+        bool valid = record.seat < header->numPlayers && (record.cards & ~kDeckMask) == 0
+                  && (record.extra == LogRecord::kNoCard || isCard(record.extra));
+        switch (static_cast<LogRecordType>(record.type)) {
+            case LogRecordType::DEAL:
+                break;
+            case LogRecordType::BAZAAR:
+            case LogRecordType::DRAW:
+            case LogRecordType::EXCHANGE:
+                valid = valid && isCard(record.card);
+                break;
+            case LogRecordType::SIGN:
+                valid = valid && record.contractType < kNumContractTypes;
+                break;
+            case LogRecordType::EXTEND:
+                valid = valid && isCard(record.card) && record.contractType < kNumContractTypes;
+                break;
+            default:
+                valid = false;
+                break;
+        }
+        if (!valid) {
+            throw std::runtime_error("Corrupt record in log");
+        }
+    }
+}
+
+GameState LoggedGame::replay() const {
+    GameState state;
+    state.numPlayers = header->numPlayers;
+    state.round = header->rounds;
+    state.phase = GamePhase::OVER;
+    state.hands.fill(0);
+
+    // Contracts are collected per owner, since GameState keeps them grouped that way
+    GameState::ContractRecord owned[GameState::kMaxPlayers][GameState::kMaxContracts];
+    int ownedCount[GameState::kMaxPlayers] = {};
+    int totalOwned = 0;
+    int supplyUsed = 0;
+    auto require = [](bool valid) {
+        if (!valid) throw std::runtime_error("Corrupt record in log");
+    };
+
+    check();
+    for (const LogRecord& record : *this) {
+        CardMask& hand = state.hands[record.seat];
+        switch (static_cast<LogRecordType>(record.type)) {
+            case LogRecordType::DEAL:
+                hand = record.cards;
+                supplyUsed += popCount(record.cards);
+                break;
+            case LogRecordType::BAZAAR:
+                require(state.bazaarSize < GameState::kBazaarSize);
+                state.bazaar[state.bazaarSize++] = record.card;
+                supplyUsed++;
+                break;
+            case LogRecordType::DRAW:
+                hand |= record.cards;
+                supplyUsed++;
+                break;
+            case LogRecordType::EXCHANGE: {
+                hand = (hand & ~record.cards) | (CardMask(1) << record.card);
+                int slot = 0;
+                while (slot < state.bazaarSize && state.bazaar[slot] != record.card) ++slot;
+                if (slot == state.bazaarSize) {
+                    throw std::runtime_error("Exchange takes a card missing from the bazaar");
+                }
+                if (record.extra != LogRecord::kNoCard) {
+                    state.bazaar[slot] = record.extra;
+                    supplyUsed++;
+                } else {
+                    for (int i = slot + 1; i < state.bazaarSize; ++i) state.bazaar[i - 1] = state.bazaar[i];
+                    state.bazaarSize--;
+                }
+                break;
+            }
+            case LogRecordType::SIGN:
+                require(totalOwned < GameState::kMaxContracts);
+                hand &= ~record.cards;
+                totalOwned++;
+                owned[record.seat][ownedCount[record.seat]++] = {
+                    record.cards, record.contractType, record.seat, record.round
+                };
+                break;
+            case LogRecordType::EXTEND:
+                require(record.contractIndex < ownedCount[record.seat]);
+                hand &= ~record.cards;
+                owned[record.seat][record.contractIndex].cards |= record.cards;
+                break;
+        }
+        require(supplyUsed <= kDeckSize);
+    }
+
+    for (int seat = 0; seat < state.numPlayers; ++seat) {
+        for (int i = 0; i < ownedCount[seat]; ++i) {
+            state.contracts[state.numContracts++] = owned[seat][i];
+        }
+    }
+    // Cards are drawn from the top (the end) of the shuffled deck
+    state.supplySize = static_cast<std::uint8_t>(kDeckSize - supplyUsed);
+    std::memcpy(state.supply.data(), header->deck, state.supplySize);
+    return state;
+}
+
+GameLogReader::GameLogReader(const std::string& path) : data_(nullptr), size_(0) {
+#ifdef _WIN32
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    mapping_ = nullptr;
+    if (file_ == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open game log " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size) || size.QuadPart < (LONGLONG)sizeof(LogFileHeader)) {
+        CloseHandle(file_);
+        throw std::runtime_error("Not a game log: " + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping_) CloseHandle(mapping_);
+        CloseHandle(file_);
+        throw std::runtime_error("Cannot map game log " + path);
+    }
+    data_ = static_cast<const unsigned char*>(view);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open game log " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(LogFileHeader)) {
+        close(fd);
+        throw std::runtime_error("Not a game log: " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    void* view = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file open
+    if (view == MAP_FAILED) {
+        throw std::runtime_error("Cannot map game log " + path);
+    }
+    madvise(view, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const unsigned char*>(view);
+#endif
+
+    const auto* header = reinterpret_cast<const LogFileHeader*>(data_);
+    if (std::memcmp(header->magic, kFileMagic, sizeof(kFileMagic)) != 0 || header->version != kFileVersion ||
+        header->gameHeaderSize != sizeof(LogGameHeader) || header->recordSize != sizeof(LogRecord)) {
+        unmap();
+        throw std::runtime_error("Unsupported game log format: " + path);
+    }
+}
+
+GameLogReader::~GameLogReader() {
+    unmap();
+}
+
+void GameLogReader::unmap() {
+    if (!data_) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+#else
+    munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+    data_ = nullptr;
+}
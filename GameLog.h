@@ -0,0 +1,181 @@
+#ifndef GAME_LOG_H
+#define GAME_LOG_H
+
+#include "EventSink.h"
+#include "GameState.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Binary game log. A file is one LogFileHeader followed by games; each game is
+// a LogGameHeader and then recordCount LogRecords. Everything is fixed width,
+// little-endian and 16-byte aligned, so a mapped file can be read in place.
+
+enum class LogRecordType : std::uint8_t {
+    DEAL,      // cards: a player's starting hand
+    BAZAAR,    // card: one starting bazaar slot, in slot order
+    DRAW,      // card: drawn from the supply
+    EXCHANGE,  // cards: given up; card: taken from the bazaar; extra: its replacement
+    SIGN,      // cards: the new contract; contractIndex: its place in the owner's list
+    EXTEND     // card: added to contract contractIndex of the owner
+};
+
+struct LogFileHeader {
+    char magic[8];              // "MEMPLOG"
+    std::uint32_t version;
+    std::uint16_t gameHeaderSize;
+    std::uint16_t recordSize;
+};
+
+struct LogGameHeader {
+    static constexpr std::uint32_t kMagic = 0x454D4147;  // "GAME"
+
+    std::uint32_t magic;
+    std::uint32_t recordCount;
+    std::uint64_t seed;         // Game(numPlayers, seed, stream) deals this game again
+    std::uint64_t stream;
+    std::uint8_t numPlayers;
+    std::uint8_t rounds;
+    std::uint8_t winner;        // Seat index
+    std::uint8_t reserved;
+    std::uint16_t points[GameState::kMaxPlayers]; // Final points by seat
+    std::uint8_t deck[kDeckSize];                 // Shuffled deck, top card last
+    std::uint8_t padding[8];
+};
+
+struct LogRecord {
+    static constexpr std::uint8_t kNoCard = 0xFF;
+
+    CardMask cards;
+    std::uint8_t type;          // LogRecordType
+    std::uint8_t round;
+    std::uint8_t seat;
+    std::uint8_t card;
+    std::uint8_t contractType;  // SIGN and EXTEND
+    std::uint8_t contractIndex; // SIGN and EXTEND
+    std::uint8_t extra;
+    std::uint8_t reserved;
+};
+
+static_assert(sizeof(LogFileHeader) == 16, "LogFileHeader must stay 16 bytes");
+static_assert(sizeof(LogGameHeader) == 96, "LogGameHeader must stay 96 bytes");
+static_assert(sizeof(LogRecord) == 16, "LogRecord must stay 16 bytes");
+
+// Appends whole games to a log file. Thread-safe, so several sinks can share one.
+// The constructor throws if the file cannot be created. A failed write does not
+// throw, since sinks flush from destructors and worker threads; it marks the
+// writer failed, later appends are dropped, and finish() reports it.
+class GameLogWriter {
+public:
+    explicit GameLogWriter(const std::string& path);
+    ~GameLogWriter();
+
+    GameLogWriter(const GameLogWriter&) = delete;
+    GameLogWriter& operator=(const GameLogWriter&) = delete;
+
+    void append(const unsigned char* data, size_t size);
+
+    // Flushes the file; false if any write since it was opened failed
+    bool finish();
+
+private:
+    std::FILE* file_;
+    std::mutex mutex_;
+    bool failed_;
+};
+
+// Records a game's events and hands finished games to the writer in large
+// batches. Use one sink per thread; games from different sinks may interleave
+// in the file, but each game's block is contiguous.
+class GameLogSink : public EventSink {
+public:
+    explicit GameLogSink(GameLogWriter& writer);
+    ~GameLogSink() override;
+
+    void flush();
+
+    void onGameStart(const GameStartEvent& event) override;
+    void onCardDrawn(const CardDrawnEvent& event) override;
+    void onBazaarExchange(const BazaarExchangeEvent& event) override;
+    void onContractSigned(const ContractSignedEvent& event) override;
+    void onContractExtended(const ContractExtendedEvent& event) override;
+    void onGameOver(const GameOverEvent& event) override;
+
+private:
+    GameLogWriter& writer_;
+    LogGameHeader header_;
+    std::vector<LogRecord> records_;
+    std::vector<unsigned char> buffer_;
+
+    LogRecord& addRecord(LogRecordType type, int round, const Player& player);
+};
+
+// One game inside a mapped log
+struct LoggedGame {
+    const LogGameHeader* header;
+    const LogRecord* records;
+
+    const LogRecord* begin() const { return records; }
+    const LogRecord* end() const { return records + header->recordCount; }
+
+    // Throws std::runtime_error if a header field or record is out of range.
+    // forEachGame checks every game before visiting it.
+    void check() const;
+
+    // Final hands, contracts, bazaar and supply, rebuilt from the records alone.
+    // Throws std::runtime_error at the first record that does not fit the game so far.
+    GameState replay() const;
+};
+
+// Memory-maps a log read-only and walks its games in place
+class GameLogReader {
+public:
+    explicit GameLogReader(const std::string& path);
+    ~GameLogReader();
+
+    GameLogReader(const GameLogReader&) = delete;
+    GameLogReader& operator=(const GameLogReader&) = delete;
+
+    size_t getSize() const { return size_; }
+
+    // Calls visit(const LoggedGame&) for every game in file order
+    template <typename Visit>
+    void forEachGame(Visit visit) const {
+        size_t offset = sizeof(LogFileHeader);
+        while (offset < size_) {
+            if (size_ - offset < sizeof(LogGameHeader)) {
+                throw std::runtime_error("Truncated game header in log");
+            }
+            LoggedGame game;
+            game.header = reinterpret_cast<const LogGameHeader*>(data_ + offset);
+            if (game.header->magic != LogGameHeader::kMagic) {
+                throw std::runtime_error("Corrupt game header in log");
+            }
+            offset += sizeof(LogGameHeader);
+            size_t recordBytes = size_t(game.header->recordCount) * sizeof(LogRecord);
+            if (size_ - offset < recordBytes) {
+                throw std::runtime_error("Truncated records in log");
+            }
+            game.records = reinterpret_cast<const LogRecord*>(data_ + offset);
+            offset += recordBytes;
+            game.check();
+            visit(game);
+        }
+    }
+
+private:
+    const unsigned char* data_;
+    size_t size_;
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#endif
+
+    void unmap();
+};
+
+#endif
@@ -0,0 +1,656 @@
+#include "GameServer.h"
+#include <stdexcept>
+
+#ifdef __linux__
+
+#include "ServerTable.h"
+#include "WebSocket.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sstream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+constexpr size_t kMaxRequestBytes = 8192;
+constexpr size_t kMaxMessageBytes = 4096;
+constexpr size_t kMaxPendingOutput = 1 << 20;  // A client this far behind is dropped
+constexpr size_t kIdleBufferBytes = 256;       // Larger idle buffers are released
+constexpr int kEventBatch = 256;
+
+// epoll tags for the two non-connection descriptors; connections use their fd
+constexpr std::uint64_t kListenerTag = ~std::uint64_t(0);
+constexpr std::uint64_t kWakeTag = ~std::uint64_t(1);
+
+[[noreturn]] void throwSystemError(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+struct HttpRequest {
+    std::string method;
+    std::string path;
+    std::string query;
+    std::string webSocketKey;  // Empty unless this is a WebSocket upgrade
+};
+
+bool startsWithIgnoringCase(const std::string& text, const char* prefix) {
+    size_t length = std::strlen(prefix);
+    return text.size() >= length && strncasecmp(text.c_str(), prefix, length) == 0;
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    size_t end = text.find_last_not_of(" \t\r");
+    return begin == std::string::npos ? "" : text.substr(begin, end - begin + 1);
+}
+
+bool parseHttpRequest(const std::string& head, HttpRequest& request) {
+    std::istringstream lines(head);
+    std::string line;
+    if (!std::getline(lines, line)) return false;
+    std::istringstream requestLine(line);
+    std::string target, version;
+    if (!(requestLine >> request.method >> target >> version) || target.empty() || target[0] != '/') {
+        return false;
+    }
+    size_t question = target.find('?');
+    request.path = target.substr(0, question);
+    if (question != std::string::npos) request.query = target.substr(question + 1);
+
+    bool upgrade = false;
+    std::string key;
+    while (std::getline(lines, line) && line != "\r") {
+        if (startsWithIgnoringCase(line, "upgrade:")) {
+            upgrade = startsWithIgnoringCase(trim(line.substr(8)), "websocket");
+        } else if (startsWithIgnoringCase(line, "sec-websocket-key:")) {
+            key = trim(line.substr(18));
+        }
+    }
+    if (upgrade) request.webSocketKey = key;
+    return true;
+}
+
+// Reads the whole of `text` as a decimal integer in [min, max]
+template <typename T>
+bool parseInteger(const std::string& text, T min, T max, T& value) {
+    const char* end = text.data() + text.size();
+    T parsed{};
+    auto result = std::from_chars(text.data(), end, parsed);
+    if (result.ec != std::errc() || result.ptr != end || parsed < min || parsed > max) return false;
+    value = parsed;
+    return true;
+}
+
+// Leaves `value` alone when the query has no `name`; false if it is there but out of range
+bool queryInt(const std::string& query, const std::string& name, int min, int max, int& value) {
+    size_t pos = 0;
+    while (pos < query.size()) {
+        size_t end = query.find('&', pos);
+        if (end == std::string::npos) end = query.size();
+        if (query.compare(pos, name.size() + 1, name + "=") == 0) {
+            return parseInteger(query.substr(pos + name.size() + 1, end - pos - name.size() - 1), min, max, value);
+        }
+        pos = end + 1;
+    }
+    return true;
+}
+
+// Table ids start at 1; see Worker::openWebSocket
+bool parseTableId(const std::string& text, std::uint64_t& id) {
+    return parseInteger(text, std::uint64_t(1), std::numeric_limits<std::uint64_t>::max(), id);
+}
+
+const char* contentType(const std::string& path) {
+    static const std::pair<const char*, const char*> kTypes[] = {
+        {".html", "text/html; charset=utf-8"}, {".js", "text/javascript"}, {".css", "text/css"},
+        {".json", "application/json"}, {".svg", "image/svg+xml"}, {".png", "image/png"},
+        {".jpg", "image/jpeg"}, {".md", "text/plain; charset=utf-8"}
+    };
+    for (const auto& type : kTypes) {
+        size_t length = std::strlen(type.first);
+        if (path.size() >= length && path.compare(path.size() - length, length, type.first) == 0) {
+            return type.second;
+        }
+    }
+    return "application/octet-stream";
+}
+
+std::string httpResponse(const char* status, const char* type, const std::string& body) {
+    std::string response = "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: ";
+    response += type;
+    response += "\r\nContent-Length: " + std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    return response + body;
+}
+
+void appendJsonString(std::string& out, const std::string& text) {
+    out.push_back('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out.push_back(' ');
+        } else {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+struct Connection {
+    int fd;
+    bool webSocket = false;
+    bool closeAfterWrite = false;
+    bool writeWatched = false;  // EPOLLOUT is registered
+    std::uint64_t tableId = 0;  // 0 while not at a table
+    int seat = -1;
+    std::string in;
+    std::string out;
+    ServerTable::ViewHashes sent{};
+
+    explicit Connection(int fd) : fd(fd) {}
+};
+
+}
+
+class GameServer::Worker {
+public:
+    Worker(GameServer& server, int index, int listenFd);
+    ~Worker();
+
+    void run();
+    void wake();
+    // Takes over a connection accepted by another worker, with the request read so far
+    void adopt(int fd, std::string request);
+
+private:
+    struct HostedTable {
+        std::unique_ptr<ServerTable> table;
+        std::vector<int> fds;
+    };
+
+    GameServer& server_;
+    int index_;
+    int listenFd_;
+    int epollFd_;
+    int wakeFd_;
+    std::uint64_t tablesCreated_;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+    std::unordered_map<std::uint64_t, HostedTable> tables_;
+    std::vector<int> doomed_;  // Connections to close once the current event is handled
+
+    std::mutex inboxMutex_;
+    std::vector<std::pair<int, std::string>> inbox_;
+
+    void acceptConnections();
+    void drainInbox();
+    void addConnection(int fd, std::string pending);
+    void closeDoomed();
+
+    void onReadable(Connection& connection);
+    void handleHttp(Connection& connection);
+    void openWebSocket(Connection& connection, const HttpRequest& request);
+    void handleFrames(Connection& connection);
+
+    void send(Connection& connection, const std::string& data);
+    void sendText(Connection& connection, const std::string& text);
+    void flush(Connection& connection);
+    void watchWrites(Connection& connection, bool watch);
+    void releaseIdleBuffers(Connection& connection);
+    void broadcast(HostedTable& hosted);
+};
+
+GameServer::Worker::Worker(GameServer& server, int index, int listenFd)
+    : server_(server), index_(index), listenFd_(listenFd), epollFd_(-1), wakeFd_(-1), tablesCreated_(0) {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0) {
+        int error = errno;
+        if (epollFd_ >= 0) close(epollFd_);
+        if (wakeFd_ >= 0) close(wakeFd_);
+        close(listenFd_);
+        errno = error;
+        throwSystemError("Cannot create server event loop");
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = kListenerTag;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event);
+    event.data.u64 = kWakeTag;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+}
+
+GameServer::Worker::~Worker() {
+    for (const auto& entry : connections_) close(entry.first);
+    for (const auto& handoff : inbox_) close(handoff.first);
+    if (wakeFd_ >= 0) close(wakeFd_);
+    if (epollFd_ >= 0) close(epollFd_);
+    close(listenFd_);
+}
+
+void GameServer::Worker::wake() {
+    std::uint64_t one = 1;
+    ssize_t written = write(wakeFd_, &one, sizeof(one));
+    (void)written;  // A full counter already means a pending wake-up
+}
+
+void GameServer::Worker::adopt(int fd, std::string request) {
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex_);
+        inbox_.emplace_back(fd, std::move(request));
+    }
+    wake();
+}
+
+void GameServer::Worker::run() {
+    epoll_event events[kEventBatch];
+    while (!server_.stopping_.load(std::memory_order_relaxed)) {
+        int count = epoll_wait(epollFd_, events, kEventBatch, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            throwSystemError("epoll_wait failed");
+        }
+        for (int i = 0; i < count; ++i) {
+            std::uint64_t tag = events[i].data.u64;
+            if (tag == kListenerTag) {
+                acceptConnections();
+            } else if (tag == kWakeTag) {
+                std::uint64_t value;
+                ssize_t drained = read(wakeFd_, &value, sizeof(value));
+                (void)drained;
+                drainInbox();
+            } else {
+                auto it = connections_.find(static_cast<int>(tag));
+                if (it == connections_.end()) continue;
+                Connection& connection = *it->second;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    doomed_.push_back(connection.fd);
+                } else {
+                    if (events[i].events & EPOLLOUT) flush(connection);
+                    if (events[i].events & EPOLLIN) onReadable(connection);
+                }
+            }
+            closeDoomed();
+        }
+    }
+}
+
+void GameServer::Worker::acceptConnections() {
+    for (;;) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN, or out of descriptors until some close
+        addConnection(fd, std::string());
+    }
+}
+
+void GameServer::Worker::drainInbox() {
+    std::vector<std::pair<int, std::string>> handoffs;
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex_);
+        handoffs.swap(inbox_);
+    }
+    for (auto& handoff : handoffs) {
+        addConnection(handoff.first, std::move(handoff.second));
+    }
+}
+
+void GameServer::Worker::addConnection(int fd, std::string pending) {
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = static_cast<std::uint64_t>(fd);
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+        close(fd);
+        return;
+    }
+    auto connection = std::make_unique<Connection>(fd);
+    connection->in = std::move(pending);
+    Connection& added = *connection;
+    connections_[fd] = std::move(connection);
+    if (!added.in.empty()) handleHttp(added);
+}
+
+void GameServer::Worker::closeDoomed() {
+    // Leaving a table can broadcast, and a failed send dooms more connections
+    while (!doomed_.empty()) {
+        int fd = doomed_.back();
+        doomed_.pop_back();
+        auto it = connections_.find(fd);
+        if (it == connections_.end()) continue;
+        std::unique_ptr<Connection> connection = std::move(it->second);
+        connections_.erase(it);
+        close(fd);
+
+        auto table = tables_.find(connection->tableId);
+        if (table == tables_.end()) continue;
+        HostedTable& hosted = table->second;
+        hosted.fds.erase(std::find(hosted.fds.begin(), hosted.fds.end(), fd));
+        if (connection->seat >= 0) hosted.table->leave(connection->seat);
+        if (hosted.table->getHumanCount() == 0) {
+            // Nobody is left to play; spectators go with the table
+            for (int watcher : hosted.fds) doomed_.push_back(watcher);
+            for (int watcher : hosted.fds) connections_[watcher]->tableId = 0;
+            tables_.erase(table);
+        } else {
+            broadcast(hosted);
+        }
+    }
+}
+
+void GameServer::Worker::onReadable(Connection& connection) {
+    char buffer[16384];
+    for (;;) {
+        ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.in.append(buffer, static_cast<size_t>(received));
+            if (received < (ssize_t)sizeof(buffer)) break;
+        } else if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            doomed_.push_back(connection.fd);
+            return;
+        } else if (errno != EINTR) {
+            break;
+        }
+    }
+    if (connection.webSocket) {
+        handleFrames(connection);
+    } else {
+        handleHttp(connection);
+    }
+}
+
+void GameServer::Worker::handleHttp(Connection& connection) {
+    size_t headEnd = connection.in.find("\r\n\r\n");
+    if (headEnd == std::string::npos) {
+        if (connection.in.size() > kMaxRequestBytes) {
+            connection.closeAfterWrite = true;
+            send(connection, httpResponse("431 Request Header Fields Too Large", "text/plain", ""));
+        }
+        return;
+    }
+
+    HttpRequest request;
+    if (!parseHttpRequest(connection.in.substr(0, headEnd + 2), request)) {
+        connection.closeAfterWrite = true;
+        send(connection, httpResponse("400 Bad Request", "text/plain", "Bad request\n"));
+        return;
+    }
+    if (request.method != "GET") {
+        connection.closeAfterWrite = true;
+        send(connection, httpResponse("405 Method Not Allowed", "text/plain", "Only GET is supported\n"));
+        return;
+    }
+
+    if (!request.webSocketKey.empty() && request.path.compare(0, 4, "/ws/") == 0) {
+        // Tables live on the worker that created them; hand joins over before answering
+        std::string name = request.path.substr(4);
+        if (name != "new") {
+            std::uint64_t id = 0;
+            if (!parseTableId(name, id)) {
+                connection.closeAfterWrite = true;
+                send(connection, httpResponse("404 Not Found", "text/plain", "No such table\n"));
+                return;
+            }
+            int owner = static_cast<int>(id % server_.workers_.size());
+            if (owner != index_) {
+                int fd = connection.fd;
+                std::string pending = std::move(connection.in);
+                epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+                connections_.erase(fd);
+                server_.workers_[owner]->adopt(fd, std::move(pending));
+                return;
+            }
+        }
+        connection.in.erase(0, headEnd + 4);
+        openWebSocket(connection, request);
+        return;
+    }
+
+    // Static files, with no way out of the root
+    std::string path = request.path;
+    if (path.find("..") != std::string::npos || path.find('\\') != std::string::npos) {
+        connection.closeAfterWrite = true;
+        send(connection, httpResponse("403 Forbidden", "text/plain", "Forbidden\n"));
+        return;
+    }
+    if (path.back() == '/') path += "index.html";
+    std::ifstream file(server_.config_.root + path, std::ios::binary);
+    std::ostringstream body;
+    if (!file || !(body << file.rdbuf())) {
+        connection.closeAfterWrite = true;
+        send(connection, httpResponse("404 Not Found", "text/plain", "Not found\n"));
+        return;
+    }
+    connection.closeAfterWrite = true;
+    send(connection, httpResponse("200 OK", contentType(path), body.str()));
+}
+
+void GameServer::Worker::openWebSocket(Connection& connection, const HttpRequest& request) {
+    std::string name = request.path.substr(4);
+    std::uint64_t id = 0;
+    if (name == "new") {
+        int players = 4;
+        if (!queryInt(request.query, "players", 2, GameState::kMaxPlayers, players)) {
+            connection.closeAfterWrite = true;
+            send(connection, httpResponse("400 Bad Request", "text/plain", "players must be 2-4\n"));
+            return;
+        }
+        // Ids encode their worker, so any worker can route a join
+        id = ++tablesCreated_ * server_.workers_.size() + static_cast<std::uint64_t>(index_);
+        tables_[id].table = std::make_unique<ServerTable>(id, players, server_.config_.seed);
+    } else {
+        if (!parseTableId(name, id) || tables_.find(id) == tables_.end()) {
+            connection.closeAfterWrite = true;
+            send(connection, httpResponse("404 Not Found", "text/plain", "No such table\n"));
+            return;
+        }
+    }
+
+    HostedTable& hosted = tables_[id];
+    send(connection, "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                     "Sec-WebSocket-Accept: " + webSocketAcceptKey(request.webSocketKey) + "\r\n\r\n");
+    connection.webSocket = true;
+    connection.tableId = id;
+    connection.seat = hosted.table->join();
+    hosted.fds.push_back(connection.fd);
+
+    sendText(connection, "{\"type\":\"welcome\",\"table\":" + std::to_string(id) +
+                         ",\"seat\":" + std::to_string(connection.seat) + "}");
+    broadcast(hosted);
+    if (!connection.in.empty()) handleFrames(connection);
+}
+
+void GameServer::Worker::handleFrames(Connection& connection) {
+    size_t consumed = 0;
+    while (!connection.closeAfterWrite) {
+        WebSocketFrame frame;
+        FrameStatus status = decodeWebSocketFrame(&connection.in[consumed], connection.in.size() - consumed,
+                                                  kMaxMessageBytes, frame);
+        if (status == FrameStatus::INCOMPLETE) break;
+        if (status == FrameStatus::INVALID) {
+            doomed_.push_back(connection.fd);
+            return;
+        }
+        const char* payload = connection.in.data() + consumed + frame.payloadOffset;
+        consumed += frame.frameSize;
+
+        if (frame.opcode == WebSocketOpcode::PING) {
+            std::string pong;
+            appendWebSocketFrame(pong, WebSocketOpcode::PONG, payload, frame.payloadSize);
+            send(connection, pong);
+        } else if (frame.opcode == WebSocketOpcode::CLOSE) {
+            std::string reply;
+            appendWebSocketFrame(reply, WebSocketOpcode::CLOSE, payload, std::min<size_t>(frame.payloadSize, 2));
+            connection.closeAfterWrite = true;
+            send(connection, reply);
+        } else if (frame.opcode == WebSocketOpcode::TEXT && frame.final) {
+            auto table = tables_.find(connection.tableId);
+            if (table == tables_.end()) continue;
+            HostedTable& hosted = table->second;
+            std::string error = hosted.table->handleCommand(connection.seat, payload, frame.payloadSize);
+            if (error.empty()) {
+                broadcast(hosted);
+            } else {
+                std::string message = "{\"type\":\"error\",\"message\":";
+                appendJsonString(message, error);
+                sendText(connection, message + "}");
+            }
+        } else if (frame.opcode != WebSocketOpcode::PONG) {
+            // Commands are small text messages; anything else is a protocol error (1003)
+            const char unsupported[] = {'\x03', '\xEB'};
+            std::string reply;
+            appendWebSocketFrame(reply, WebSocketOpcode::CLOSE, unsupported, sizeof(unsupported));
+            connection.closeAfterWrite = true;
+            send(connection, reply);
+        }
+    }
+    connection.in.erase(0, consumed);
+    releaseIdleBuffers(connection);
+}
+
+void GameServer::Worker::broadcast(HostedTable& hosted) {
+    std::string view;
+    for (int fd : hosted.fds) {
+        Connection& connection = *connections_[fd];
+        view.clear();
+        if (hosted.table->writeView(connection.seat, connection.sent, view)) sendText(connection, view);
+    }
+}
+
+void GameServer::Worker::sendText(Connection& connection, const std::string& text) {
+    std::string frame;
+    appendWebSocketFrame(frame, WebSocketOpcode::TEXT, text.data(), text.size());
+    send(connection, frame);
+}
+
+void GameServer::Worker::send(Connection& connection, const std::string& data) {
+    if (connection.out.size() + data.size() > kMaxPendingOutput) {
+        doomed_.push_back(connection.fd);
+        return;
+    }
+    connection.out += data;
+    flush(connection);
+}
+
+void GameServer::Worker::flush(Connection& connection) {
+    size_t sent = 0;
+    while (sent < connection.out.size()) {
+        ssize_t written = ::send(connection.fd, connection.out.data() + sent, connection.out.size() - sent,
+                                 MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (written > 0) {
+            sent += static_cast<size_t>(written);
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            doomed_.push_back(connection.fd);
+            return;
+        }
+    }
+    connection.out.erase(0, sent);
+    watchWrites(connection, !connection.out.empty());
+    if (connection.out.empty()) {
+        if (connection.closeAfterWrite) doomed_.push_back(connection.fd);
+        releaseIdleBuffers(connection);
+    }
+}
+
+void GameServer::Worker::watchWrites(Connection& connection, bool watch) {
+    if (connection.writeWatched == watch) return;
+    epoll_event event{};
+    event.events = watch ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    event.data.u64 = static_cast<std::uint64_t>(connection.fd);
+    epoll_ctl(epollFd_, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.writeWatched = watch;
+}
+
+// Idle tables should cost their game and little else
+void GameServer::Worker::releaseIdleBuffers(Connection& connection) {
+    if (connection.in.empty() && connection.in.capacity() > kIdleBufferBytes) std::string().swap(connection.in);
+    if (connection.out.empty() && connection.out.capacity() > kIdleBufferBytes) std::string().swap(connection.out);
+}
+
+GameServer::GameServer(const ServerConfig& config)
+    : config_(config), port_(config.port), stopping_(false) {
+    int numThreads = config_.numThreads;
+    if (numThreads <= 0) numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (numThreads <= 0) numThreads = 1;
+
+    for (int i = 0; i < numThreads; ++i) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) throwSystemError("Cannot create server socket");
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<std::uint16_t>(port_));
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+            close(fd);
+            throwSystemError("Cannot listen on port " + std::to_string(port_));
+        }
+        if (port_ == 0) {
+            // Every later listener shares the port the kernel picked for the first
+            socklen_t length = sizeof(address);
+            getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+            port_ = ntohs(address.sin_port);
+        }
+        workers_.push_back(std::make_unique<Worker>(*this, i, fd));
+    }
+}
+
+GameServer::~GameServer() = default;
+
+void GameServer::run() {
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        threads.emplace_back([this, i]() { workers_[i]->run(); });
+    }
+    workers_[0]->run();
+    for (auto& thread : threads) thread.join();
+}
+
+void GameServer::stop() {
+    stopping_.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers_) worker->wake();
+}
+
+#else
+
+class GameServer::Worker {
+};
+
+GameServer::GameServer(const ServerConfig& config)
+    : config_(config), port_(config.port), stopping_(false) {
+    throw std::runtime_error("The game server needs Linux (epoll)");
+}
+
+GameServer::~GameServer() = default;
+
+void GameServer::run() {}
+
+void GameServer::stop() {}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ServerConfig {
+    int port = 8080;             // 0 picks a free port; see GameServer::getPort
+    int numThreads = 0;          // 0 = one per hardware thread
+    std::string root = ".";      // Static files served for plain HTTP requests
+    std::uint64_t seed = 1;      // Table `id` deals Game(players, seed, id)
+};
+
+// Localhost HTTP and WebSocket server hosting many concurrent ServerTables.
+// Each thread runs its own epoll loop on its own SO_REUSEPORT listener and
+// owns the tables it creates, so a table is only ever touched by one thread.
+// A connection that asks for another thread's table is handed to that thread
+// before its WebSocket handshake is answered.
+//
+// GET /ws/new?players=N creates a table and seats the caller; GET /ws/ID joins
+// table ID in its first open seat, or as a spectator. Any other GET serves a
+// file under `root`. Linux only; elsewhere the constructor throws.
+class GameServer {
+public:
+    explicit GameServer(const ServerConfig& config);
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    int getPort() const { return port_; }
+
+    // Serves on the calling thread plus numThreads - 1 more until stop()
+    void run();
+    // Safe from any thread and from signal handlers
+    void stop();
+
+private:
+    class Worker;
+
+    ServerConfig config_;
+    int port_;
+    std::atomic<bool> stopping_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include "Card.h"
+#include "Rng.h"
+#include <array>
+#include <cstdint>
+
+enum class GamePhase : std::uint8_t {
+    MAIN,         // Regular turns while the supply lasts
+    FINAL_ROUND,  // Each player gets one last deal phase
+    OVER
+};
+
+// Flat, allocation-free copy of everything that drives a game forward.
+// Cards are stored as deck indices (Card::getIndex) and hands as masks.
+struct GameState {
+    static constexpr int kMaxPlayers = 4;
+    static constexpr int kBazaarSize = 5;
+    static constexpr int kMaxContracts = kDeckSize / 3;
+
+    struct ContractRecord {
+        CardMask cards;
+        std::uint8_t type;        // ContractType
+        std::uint8_t owner;       // Seat index
+        std::uint8_t roundCreated;
+    };
+
+    std::array<std::uint8_t, kDeckSize> supply;    // Top of the supply is the last entry
+    std::array<std::uint8_t, kBazaarSize> bazaar;
+    std::array<CardMask, kMaxPlayers> hands;
+    std::array<ContractRecord, kMaxContracts> contracts;  // Grouped by owner, oldest first
+
+    std::uint8_t supplySize = 0;
+    std::uint8_t bazaarSize = 0;
+    std::uint8_t numContracts = 0;
+    std::uint8_t numPlayers = 0;
+    std::uint8_t round = 0;
+    std::uint8_t seat = 0;    // Seat whose turn is next, or in progress mid deal phase
+    std::uint16_t dealsRemaining = 0;  // Deals left in a deal phase in progress
+    GamePhase phase = GamePhase::MAIN;
+
+    Rng rng;
+};
+
+#endif
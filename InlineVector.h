@@ -0,0 +1,48 @@
+#ifndef INLINE_VECTOR_H
+#define INLINE_VECTOR_H
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+// A vector with a fixed capacity, stored inline: no heap allocation, and
+// copying or moving one is a flat copy. For short lists with a hard size limit,
+// such as the cards of a contract.
+template <typename T, int Capacity>
+class InlineVector {
+public:
+    static_assert(Capacity > 0 && Capacity <= 255, "The size is kept in one byte");
+
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    int size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr int capacity() { return Capacity; }
+
+    T* begin() { return items_.data(); }
+    T* end() { return items_.data() + size_; }
+    const T* begin() const { return items_.data(); }
+    const T* end() const { return items_.data() + size_; }
+
+    T& operator[](int index) { return items_[index]; }
+    const T& operator[](int index) const { return items_[index]; }
+    const T& front() const { return items_[0]; }
+    const T& back() const { return items_[size_ - 1]; }
+
+    void push_back(const T& item) {
+        if (size_ == Capacity) {
+            throw std::length_error("InlineVector is full");
+        }
+        items_[size_++] = item;
+    }
+    void pop_back() { --size_; }
+    void clear() { size_ = 0; }
+
+private:
+    std::array<T, Capacity> items_;
+    std::uint8_t size_ = 0;
+};
+
+#endif
@@ -0,0 +1,610 @@
+#include "LockstepEngine.h"
+#include "BarterEvaluator.h"
+#include "Contract.h"
+#include "ContractUniverse.h"
+#include "GameState.h"
+#include "Rng.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr int kLanes = LockstepEngine::kLanes;
+constexpr int kMaxSeats = GameState::kMaxPlayers;
+constexpr int kMaxRun = ContractUniverse::kMaxSize;
+constexpr int kUnlimitedDeals = 999;
+
+static_assert(kLanes == 64, "Active lanes are tracked as one 64-bit mask");
+
+template <typename T>
+using PerLane = std::array<T, kLanes>;
+
+// Longest run in a lane, capped at kMaxRun, with Q-K-A as a run of 3; 0 below 3
+int runLength(std::uint32_t lane) {
+    int length = 0;
+    for (std::uint32_t run = lane; run && length < kMaxRun; run &= run >> 1) ++length;
+    if (length < 3 && (lane & kWrapRun) == kWrapRun) length = 3;
+    return length >= 3 ? length : 0;
+}
+
+void findHandShape(CardMask hand, HandShapes& shape) {
+    std::uint32_t lanes[kNumSuits];
+    std::uint32_t ranks = 0;
+    for (int suit = 0; suit < kNumSuits; ++suit) {
+        lanes[suit] = suitLane(hand, suit);
+        ranks |= lanes[suit];
+        int cards = std::min(popCount(lanes[suit]), kMaxRun);
+        shape.silkRoad[suit] = static_cast<std::uint8_t>(runLength(lanes[suit]));
+        shape.partnership[suit] = static_cast<std::uint8_t>(cards >= 3 ? cards : 0);
+    }
+    shape.tradeRoute = static_cast<std::uint8_t>(runLength(ranks));
+
+    std::uint32_t triples = (lanes[0] & lanes[1] & (lanes[2] | lanes[3])) | ((lanes[0] | lanes[1]) & lanes[2] & lanes[3]);
+    std::uint32_t quads = lanes[0] & lanes[1] & lanes[2] & lanes[3];
+    shape.monopoly = static_cast<std::uint8_t>(quads ? 4 : triples ? 3 : 0);
+}
+
+#if defined(__AVX2__)
+
+// Sixteen 16-bit lanes at a time; each function mirrors its scalar twin above
+
+__m256i runLength16(__m256i lane) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i length = zero;
+    __m256i run = lane;
+    for (int step = 0; step < kMaxRun; ++step) {
+        // A set compare lane is -1, so subtracting it counts the step
+        length = _mm256_sub_epi16(length, _mm256_andnot_si256(_mm256_cmpeq_epi16(run, zero), _mm256_set1_epi16(-1)));
+        run = _mm256_and_si256(run, _mm256_srli_epi16(run, 1));
+    }
+    const __m256i wrap = _mm256_set1_epi16(static_cast<short>(kWrapRun));
+    __m256i wraps = _mm256_cmpeq_epi16(_mm256_and_si256(lane, wrap), wrap);
+    length = _mm256_max_epu16(length, _mm256_and_si256(wraps, _mm256_set1_epi16(3)));
+    return _mm256_and_si256(length, _mm256_cmpgt_epi16(length, _mm256_set1_epi16(2)));
+}
+
+__m256i popCount16(__m256i lane) {
+    const __m256i nibbles = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                             0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(nibbles, _mm256_and_si256(lane, low)),
+                                    _mm256_shuffle_epi8(nibbles, _mm256_and_si256(_mm256_srli_epi16(lane, 4), low)));
+    return _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0xFF)), _mm256_srli_epi16(bytes, 8));
+}
+
+void findHandShapes16(const CardMask* hands, HandShapes* shapes) {
+    alignas(32) std::uint16_t lanes[kNumSuits][16];
+    for (int i = 0; i < 16; ++i) {
+        for (int suit = 0; suit < kNumSuits; ++suit) {
+            lanes[suit][i] = static_cast<std::uint16_t>(suitLane(hands[i], suit));
+        }
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i seven = _mm256_set1_epi16(kMaxRun);
+    const __m256i two = _mm256_set1_epi16(2);
+    __m256i lane[kNumSuits];
+    alignas(32) std::uint16_t silkRoad[kNumSuits][16];
+    alignas(32) std::uint16_t partnership[kNumSuits][16];
+    __m256i ranks = zero;
+    for (int suit = 0; suit < kNumSuits; ++suit) {
+        lane[suit] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes[suit]));
+        ranks = _mm256_or_si256(ranks, lane[suit]);
+        __m256i cards = _mm256_min_epu16(popCount16(lane[suit]), seven);
+        cards = _mm256_and_si256(cards, _mm256_cmpgt_epi16(cards, two));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(silkRoad[suit]), runLength16(lane[suit]));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(partnership[suit]), cards);
+    }
+
+    alignas(32) std::uint16_t tradeRoute[16];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(tradeRoute), runLength16(ranks));
+
+    __m256i triples = _mm256_or_si256(
+        _mm256_and_si256(_mm256_and_si256(lane[0], lane[1]), _mm256_or_si256(lane[2], lane[3])),
+        _mm256_and_si256(_mm256_or_si256(lane[0], lane[1]), _mm256_and_si256(lane[2], lane[3])));
+    __m256i quads = _mm256_and_si256(_mm256_and_si256(lane[0], lane[1]), _mm256_and_si256(lane[2], lane[3]));
+    __m256i monopolies = _mm256_max_epu16(
+        _mm256_andnot_si256(_mm256_cmpeq_epi16(triples, zero), _mm256_set1_epi16(3)),
+        _mm256_andnot_si256(_mm256_cmpeq_epi16(quads, zero), _mm256_set1_epi16(4)));
+    alignas(32) std::uint16_t monopoly[16];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(monopoly), monopolies);
+
+    for (int i = 0; i < 16; ++i) {
+        for (int suit = 0; suit < kNumSuits; ++suit) {
+            shapes[i].silkRoad[suit] = static_cast<std::uint8_t>(silkRoad[suit][i]);
+            shapes[i].partnership[suit] = static_cast<std::uint8_t>(partnership[suit][i]);
+        }
+        shapes[i].tradeRoute = static_cast<std::uint8_t>(tradeRoute[i]);
+        shapes[i].monopoly = static_cast<std::uint8_t>(monopoly[i]);
+    }
+}
+
+#endif
+
+// Points per card of a over b, compared exactly
+bool moreEfficient(ContractType a, int sizeA, ContractType b, int sizeB) {
+    return Contract::calculatePoints(a, sizeA) * sizeB > Contract::calculatePoints(b, sizeB) * sizeA;
+}
+
+struct Candidate {
+    ContractType type = ContractType::PARTNERSHIP;
+    CardMask cards = 0;  // 0 when the hand has no contract
+};
+
+// The contract Player::selectBestContract picks: the most efficient, taking the
+// first of its lanes (suits, then trade route slots, then ranks) on a tie, and
+// the lowest cards within that lane
+Candidate bestCandidate(CardMask hand, const HandShapes& shape) {
+    ContractType bestType = ContractType::PARTNERSHIP;
+    int bestSize = 0;
+    auto consider = [&](ContractType type, int size) {
+        if (size >= 3 && (bestSize == 0 || moreEfficient(type, size, bestType, bestSize))) {
+            bestType = type;
+            bestSize = size;
+        }
+    };
+    for (int suit = 0; suit < kNumSuits; ++suit) {
+        consider(ContractType::SILK_ROAD, shape.silkRoad[suit]);
+        consider(ContractType::PARTNERSHIP, shape.partnership[suit]);
+    }
+    consider(ContractType::TRADE_ROUTE, shape.tradeRoute);
+    consider(ContractType::MONOPOLY, shape.monopoly);
+    if (bestSize == 0) return {};
+
+    auto isBest = [&](ContractType type, int size) {
+        return size >= 3 && !moreEfficient(bestType, bestSize, type, size);
+    };
+
+    for (int suit = 0; suit < kNumSuits; ++suit) {
+        std::uint32_t lane = suitLane(hand, suit);
+        int length = shape.silkRoad[suit];
+        if (isBest(ContractType::SILK_ROAD, length)) {
+            std::uint32_t lowest = kLaneMask;
+            for (const auto& runs : kContractUniverse.runs) {
+                for (std::uint32_t run : runs) {
+                    if (popCount(run) == length && (run & lane) == run) lowest = std::min(lowest, run);
+                }
+            }
+            return {ContractType::SILK_ROAD, laneToMask(lowest, suit)};
+        }
+        int cards = shape.partnership[suit];
+        if (isBest(ContractType::PARTNERSHIP, cards)) {
+            std::uint32_t ranks = 0;
+            for (int i = 0; i < cards; ++i) {
+                ranks |= lane & (~lane + 1);
+                lane &= lane - 1;
+            }
+            return {ContractType::PARTNERSHIP, laneToMask(ranks, suit)};
+        }
+    }
+
+    std::uint32_t ranks = rankUnion(hand);
+    for (const auto& runs : kContractUniverse.runs) {
+        // Each slot's longest held run heads its lane
+        std::uint32_t longest = 0;
+        for (std::uint32_t run : runs) {
+            if ((run & ranks) != run) break;
+            longest = run;
+        }
+        if (longest && isBest(ContractType::TRADE_ROUTE, popCount(longest))) {
+            CardMask cards = 0;
+            for (std::uint32_t bits = longest; bits; bits &= bits - 1) {
+                CardMask column = hand & rankColumn(lowestBitIndex(bits));
+                cards |= column & (~column + 1);
+            }
+            return {ContractType::TRADE_ROUTE, cards};
+        }
+    }
+
+    for (int rank = 0; rank < kRanksPerSuit; ++rank) {
+        CardMask column = hand & rankColumn(rank);
+        int size = std::min(popCount(column), kNumSuits);
+        if (isBest(ContractType::MONOPOLY, size)) {
+            // The lowest suits are the lowest bits of the column
+            CardMask cards = 0;
+            for (int i = 0; i < size; ++i) {
+                cards |= column & (~column + 1);
+                column &= column - 1;
+            }
+            return {ContractType::MONOPOLY, cards};
+        }
+    }
+    return {};
+}
+
+// Lowest card of `cards` in rank order, the order GreedyStrategy tries them in
+int firstInRankOrder(CardMask cards) {
+    for (int rank = 0; rank < kRanksPerSuit; ++rank) {
+        CardMask column = cards & rankColumn(rank);
+        if (column) return lowestBitIndex(column);
+    }
+    return -1;
+}
+
+// kLanes games side by side. Every field is an array over the lanes, so one
+// field of the whole block is contiguous; a game is one column.
+struct Block {
+    int numPlayers = 0;
+    std::uint64_t active = 0;  // Lanes whose game is still being played
+
+    std::array<PerLane<std::uint8_t>, kDeckSize> supply;  // Card indices; the top is at supplySize - 1
+    PerLane<std::uint8_t> supplySize;
+    std::array<PerLane<std::uint8_t>, GameState::kBazaarSize> bazaar;
+    PerLane<std::uint8_t> bazaarSize;
+    PerLane<std::uint8_t> round;
+    PerLane<std::uint8_t> seat;
+    PerLane<GamePhase> phase;
+    PerLane<int> dealsRemaining;
+
+    std::array<PerLane<CardMask>, kMaxSeats> hands;
+
+    // Score ledgers, kept as Player keeps its own
+    std::array<PerLane<int>, kMaxSeats> points;
+    std::array<PerLane<int>, kMaxSeats> supplyBonus;
+    std::array<PerLane<int>, kMaxSeats> bonusDeals;
+    std::array<PerLane<int>, kMaxSeats> unlimitedDeals;
+    std::array<PerLane<int>, kMaxSeats> contractCount;
+
+    // Contracts of every seat, in signing order
+    PerLane<std::uint8_t> numContracts;
+    std::array<PerLane<CardMask>, kMaxContractsPerGame> contractCards;
+    std::array<PerLane<CardMask>, kMaxContractsPerGame> contractFrontier;
+    std::array<PerLane<ContractType>, kMaxContractsPerGame> contractType;
+    std::array<PerLane<std::uint8_t>, kMaxContractsPerGame> contractOwner;
+    std::array<PerLane<std::uint8_t>, kMaxContractsPerGame> contractRound;
+
+    // Scratch for one deal step of the block
+    PerLane<CardMask> dealingHands;
+    PerLane<HandShapes> dealingShapes;
+    PerLane<std::uint8_t> dealingLanes;
+    std::vector<Card> offers;
+
+    int draw(int lane) { return supply[--supplySize[lane]][lane]; }
+
+    void start(int lane, std::uint64_t seed, std::uint64_t stream);
+    void play(TournamentResults& results);
+
+    void supplyPhase(int lane);
+    void barterPhase(int lane);
+    bool playDeal(int lane, const HandShapes& shape);  // False on a hold
+    void sign(int lane, ContractType type, CardMask cards);
+    void extend(int lane, int contract, int cardIndex);
+    void tally(int lane, int contract, int sign);
+    int getTotalDeals(int lane, int player) const;
+    void record(int lane, TournamentResults& results) const;
+};
+
+void Block::start(int lane, std::uint64_t seed, std::uint64_t stream) {
+    // The same shuffle as Game::reset, so the lane plays game `stream`
+    Rng rng(seed, stream);
+    std::array<std::uint8_t, kDeckSize> deck;
+    std::iota(deck.begin(), deck.end(), 0);
+    rng.shuffle(deck.begin(), deck.end());
+    for (int i = 0; i < kDeckSize; ++i) {
+        supply[i][lane] = deck[i];
+    }
+    supplySize[lane] = kDeckSize;
+
+    round[lane] = 0;
+    seat[lane] = 0;
+    phase[lane] = GamePhase::MAIN;
+    dealsRemaining[lane] = 0;
+    numContracts[lane] = 0;
+    for (int player = 0; player < kMaxSeats; ++player) {
+        hands[player][lane] = 0;
+        points[player][lane] = 0;
+        supplyBonus[player][lane] = 0;
+        bonusDeals[player][lane] = 0;
+        unlimitedDeals[player][lane] = 0;
+        contractCount[player][lane] = 0;
+    }
+
+    int cardsPerPlayer = (numPlayers == 3) ? 7 : 6;
+    for (int i = 0; i < cardsPerPlayer; ++i) {
+        for (int player = 0; player < numPlayers; ++player) {
+            hands[player][lane] |= CardMask(1) << draw(lane);
+        }
+    }
+    bazaarSize[lane] = 0;
+    for (int i = 0; i < GameState::kBazaarSize; ++i) {
+        bazaar[bazaarSize[lane]++][lane] = static_cast<std::uint8_t>(draw(lane));
+    }
+    active |= std::uint64_t(1) << lane;
+}
+
+void Block::play(TournamentResults& results) {
+    while (active) {
+        // Supply and barter phases, as Game::beginTurn plays them
+        for (std::uint64_t lanes = active; lanes; lanes &= lanes - 1) {
+            int lane = lowestBitIndex(lanes);
+            if (phase[lane] == GamePhase::MAIN && supplySize[lane] == 0) {
+                phase[lane] = GamePhase::FINAL_ROUND;
+                seat[lane] = 0;
+            }
+            if (phase[lane] == GamePhase::MAIN) {
+                if (seat[lane] == 0) round[lane]++;
+                supplyPhase(lane);
+                barterPhase(lane);
+            }
+            dealsRemaining[lane] = getTotalDeals(lane, seat[lane]);
+        }
+
+        // Deal phases: every lane still dealing makes its next deal together
+        for (std::uint64_t dealing = active; dealing;) {
+            int count = 0;
+            for (std::uint64_t lanes = dealing; lanes; lanes &= lanes - 1) {
+                int lane = lowestBitIndex(lanes);
+                dealingLanes[count] = static_cast<std::uint8_t>(lane);
+                dealingHands[count++] = hands[seat[lane]][lane];
+            }
+            findHandShapes(dealingHands.data(), count, dealingShapes.data());
+            for (int i = 0; i < count; ++i) {
+                int lane = dealingLanes[i];
+                if (!playDeal(lane, dealingShapes[i]) || --dealsRemaining[lane] == 0) {
+                    dealing &= ~(std::uint64_t(1) << lane);
+                }
+            }
+        }
+
+        for (std::uint64_t lanes = active; lanes; lanes &= lanes - 1) {
+            int lane = lowestBitIndex(lanes);
+            dealsRemaining[lane] = 0;
+            if (++seat[lane] == numPlayers) {
+                seat[lane] = 0;
+                if (phase[lane] == GamePhase::FINAL_ROUND) {
+                    phase[lane] = GamePhase::OVER;
+                    record(lane, results);
+                    active &= ~(std::uint64_t(1) << lane);
+                }
+            }
+        }
+    }
+}
+
+void Block::supplyPhase(int lane) {
+    CardMask& hand = hands[seat[lane]][lane];
+    int draws = std::min(1 + supplyBonus[seat[lane]][lane], static_cast<int>(supplySize[lane]));
+    for (int i = 0; i < draws; ++i) {
+        hand |= CardMask(1) << draw(lane);
+    }
+}
+
+void Block::barterPhase(int lane) {
+    int player = seat[lane];
+    CardMask& hand = hands[player][lane];
+
+    // Each trade-rights contract allows one exchange per turn
+    for (int route = 0; route < numContracts[lane]; ++route) {
+        ContractType type = contractType[route][lane];
+        int cost = Contract::getTradeCost(type, popCount(contractCards[route][lane]));
+        if (contractOwner[route][lane] != player || !Contract::hasTradeRights(type) ||
+            bazaarSize[lane] == 0 || popCount(hand) < cost) {
+            continue;
+        }
+
+        offers.clear();
+        for (int i = 0; i < bazaarSize[lane]; ++i) {
+            offers.push_back(Card::fromIndex(bazaar[i][lane]));
+        }
+        BarterEvaluator evaluator(hand, offers);
+        for (int contract = 0; contract < numContracts[lane]; ++contract) {
+            if (contractOwner[contract][lane] == player) {
+                evaluator.addContract(contractType[contract][lane], popCount(contractCards[contract][lane]),
+                                      contractFrontier[contract][lane]);
+            }
+        }
+        ExchangeDecision decision = evaluator.bestExchange(hand, cost);
+        if (!decision.trade) continue;
+
+        // Given cards leave the game; the taken slot is refilled from the supply
+        int slot = decision.bazaarIndex;
+        hand = (hand & ~decision.give) | (CardMask(1) << bazaar[slot][lane]);
+        if (supplySize[lane] > 0) {
+            bazaar[slot][lane] = static_cast<std::uint8_t>(draw(lane));
+        } else {
+            for (int i = slot + 1; i < bazaarSize[lane]; ++i) {
+                bazaar[i - 1][lane] = bazaar[i][lane];
+            }
+            bazaarSize[lane]--;
+        }
+    }
+}
+
+bool Block::playDeal(int lane, const HandShapes& shape) {
+    int player = seat[lane];
+    Candidate best = bestCandidate(hands[player][lane], shape);
+    if (!best.cards) return false;
+
+    // GreedyStrategy: extend the first contract one of the candidate's cards extends
+    for (int contract = 0; contract < numContracts[lane]; ++contract) {
+        CardMask cards = best.cards & contractFrontier[contract][lane];
+        if (cards && contractOwner[contract][lane] == player) {
+            extend(lane, contract, firstInRankOrder(cards));
+            return true;
+        }
+    }
+    sign(lane, best.type, best.cards);
+    return true;
+}
+
+void Block::sign(int lane, ContractType type, CardMask cards) {
+    int player = seat[lane];
+    int contract = numContracts[lane]++;
+    contractCards[contract][lane] = cards;
+    contractFrontier[contract][lane] = Contract::calculateFrontier(type, cards);
+    contractType[contract][lane] = type;
+    contractOwner[contract][lane] = static_cast<std::uint8_t>(player);
+    contractRound[contract][lane] = round[lane];
+    contractCount[player][lane]++;
+    tally(lane, contract, 1);
+    hands[player][lane] &= ~cards;
+}
+
+void Block::extend(int lane, int contract, int cardIndex) {
+    CardMask card = CardMask(1) << cardIndex;
+    tally(lane, contract, -1);
+    contractCards[contract][lane] |= card;
+    contractFrontier[contract][lane] = Contract::calculateFrontier(contractType[contract][lane], contractCards[contract][lane]);
+    tally(lane, contract, 1);
+    hands[seat[lane]][lane] &= ~card;
+}
+
+void Block::tally(int lane, int contract, int sign) {
+    int player = contractOwner[contract][lane];
+    ContractType type = contractType[contract][lane];
+    int size = popCount(contractCards[contract][lane]);
+    points[player][lane] += sign * Contract::calculatePoints(type, size);
+    supplyBonus[player][lane] += sign * Contract::getSupplyBonus(type, size);
+    int deals = Contract::getBonusDeals(type, size);
+    if (deals >= kUnlimitedDeals) {
+        unlimitedDeals[player][lane] += sign;
+    } else {
+        bonusDeals[player][lane] += sign * deals;
+    }
+}
+
+int Block::getTotalDeals(int lane, int player) const {
+    if (unlimitedDeals[player][lane] > 0) return kUnlimitedDeals;
+    return 1 + bonusDeals[player][lane];
+}
+
+void Block::record(int lane, TournamentResults& results) const {
+    // Game::getWinner: most points, then most contracts, then the earliest seat
+    int winner = 0;
+    for (int player = 1; player < numPlayers; ++player) {
+        if (points[player][lane] > points[winner][lane] ||
+            (points[player][lane] == points[winner][lane] && contractCount[player][lane] > contractCount[winner][lane])) {
+            winner = player;
+        }
+    }
+
+    results.gamesPlayed++;
+    results.rounds.add(round[lane]);
+    results.winsBySeat[winner]++;
+
+    int bestOther = 0;
+    for (int player = 0; player < numPlayers; ++player) {
+        if (player != winner) bestOther = std::max(bestOther, points[player][lane]);
+        results.points.add(points[player][lane]);
+        results.pointsHistogram.add(points[player][lane]);
+
+        int guildStanding = 0, caravanCapacity = 0, marketShare = 0, silkRoadMarks = 0;
+        for (int contract = 0; contract < numContracts[lane]; ++contract) {
+            if (contractOwner[contract][lane] != player) continue;
+            CardMask cards = contractCards[contract][lane];
+            int type = static_cast<int>(contractType[contract][lane]);
+            int size = popCount(cards);
+            results.contractsBySize[type][std::min(size, TournamentResults::kMaxContractSize)]++;
+            results.contractsByRound[type][std::min<int>(contractRound[contract][lane], TournamentResults::kMaxTrackedRounds - 1)]++;
+
+            switch (contractType[contract][lane]) {
+                case ContractType::PARTNERSHIP:
+                    guildStanding += size;
+                    if (Contract::isRun(suitLane(cards, lowestBitIndex(cards) / kRanksPerSuit))) silkRoadMarks++;
+                    break;
+                case ContractType::SILK_ROAD:
+                    guildStanding += size;
+                    caravanCapacity += size;
+                    silkRoadMarks++;
+                    break;
+                case ContractType::TRADE_ROUTE:
+                    caravanCapacity += size;
+                    break;
+                case ContractType::MONOPOLY:
+                    marketShare += size;
+                    break;
+            }
+        }
+        results.guildStanding.add(guildStanding);
+        results.caravanCapacity.add(caravanCapacity);
+        results.marketShare.add(marketShare);
+        results.silkRoadMarks.add(silkRoadMarks);
+    }
+    results.winningMargin.add(points[winner][lane] - bestOther);
+}
+
+}
+
+void findHandShapes(const CardMask* hands, int count, HandShapes* shapes) {
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 16 <= count; i += 16) {
+        findHandShapes16(hands + i, shapes + i);
+    }
+#endif
+    for (; i < count; ++i) {
+        findHandShape(hands[i], shapes[i]);
+    }
+}
+
+LockstepEngine::LockstepEngine(const TournamentConfig& config) : config_(config) {
+    if (config.numPlayers < 2 || config.numPlayers > kMaxSeats) {
+        throw std::invalid_argument("A game needs 2 to 4 players");
+    }
+    if (config.strategyFactory || config.log) {
+        throw std::invalid_argument("The lockstep engine only plays greedy games without a log");
+    }
+    if (config.stopping.sprtEffect != 0.0) {
+        throw std::invalid_argument("A batch stops on targetError only; the SPRT needs duplicate deals");
+    }
+}
+
+TournamentResults LockstepEngine::run() const {
+    int numThreads = config_.numThreads;
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    TournamentResults empty;
+    empty.winsBySeat.assign(config_.numPlayers, 0);
+
+    const StoppingRule& rule = config_.stopping;
+    std::function<bool(const TournamentResults&)> shouldStop;
+    if (rule.targetError > 0.0) {
+        shouldStop = [&](const TournamentResults& results) { return results.meetsTargetError(rule); };
+    }
+    ChunkSequencer<TournamentResults> sequencer(empty, shouldStop);
+    std::atomic<long long> nextChunk(0);
+
+    auto worker = [&]() {
+        auto block = std::make_unique<Block>();
+        block->numPlayers = config_.numPlayers;
+
+        for (;;) {
+            long long chunk = nextChunk.fetch_add(1);
+            long long begin = chunk * kLanes;
+            if (begin >= config_.numGames || chunk >= sequencer.getLimit()) break;
+            long long end = std::min(begin + kLanes, config_.numGames);
+            for (long long index = begin; index < end; ++index) {
+                block->start(static_cast<int>(index - begin), config_.masterSeed, static_cast<std::uint64_t>(index));
+            }
+
+            TournamentResults local = empty;
+            block->play(local);
+            sequencer.submit(chunk, std::move(local));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    TournamentResults total = sequencer.take();
+    total.stoppedEarly = sequencer.isStopped();
+    return total;
+}
@@ -0,0 +1,43 @@
+#ifndef LOCKSTEP_ENGINE_H
+#define LOCKSTEP_ENGINE_H
+
+#include "Card.h"
+#include "Tournament.h"
+#include <cstdint>
+
+// Best size of each contract type in one hand, 0 where there is none. Enough
+// to find the greedy AI's choice without listing candidates.
+struct HandShapes {
+    std::uint8_t silkRoad[kNumSuits];     // Longest run per suit, capped at 7
+    std::uint8_t partnership[kNumSuits];  // Cards per suit, capped at 7
+    std::uint8_t tradeRoute;              // Longest run of ranks held in any suit
+    std::uint8_t monopoly;                // Most suits held at one rank
+};
+
+// Shapes of `count` hands. Built with AVX2 (make AVX2=1), each run of sixteen
+// hands is one pass of 16-bit lanes; otherwise, and for the rest, one at a time.
+void findHandShapes(const CardMask* hands, int count, HandShapes* shapes);
+
+// Batch engine for all-greedy games. Game keeps each game in its own objects;
+// this keeps kLanes games as structure-of-arrays state (supply cursors, hand
+// masks, contract ledgers) and steps them a turn at a time together, so every
+// deal of the block is decided in one findHandShapes pass.
+//
+// Plays the same games as Tournament with no strategies: the results are
+// identical for the same master seed, and game i is still
+// Game(numPlayers, masterSeed, i).
+class LockstepEngine {
+public:
+    static constexpr int kLanes = 64;  // Games per block, and per stopping-rule chunk
+
+    // Only numGames, numPlayers, numThreads, masterSeed and stopping are used;
+    // a strategy factory or a log is rejected
+    explicit LockstepEngine(const TournamentConfig& config);
+
+    TournamentResults run() const;
+
+private:
+    TournamentConfig config_;
+};
+
+#endif
@@ -0,0 +1,215 @@
+#include "MctsStrategy.h"
+#include "Game.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+std::uint64_t mix(std::uint64_t hash, std::uint64_t value) {
+    hash ^= value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+}
+
+MctsStrategy::MctsStrategy(const MctsConfig& config) : config_(config) {}
+
+DealDecision MctsStrategy::chooseDeal(const Game& game, const Player&) {
+    GameState root = game.snapshot();
+    int seat = game.getCurrentSeat();
+    // Seeded from the position itself, so a decision does not depend on which
+    // thread or in which order games are played
+    std::uint64_t seed = mix(config_.seed, game.getHash());
+
+    int numThreads = std::max(1, config_.threads);
+    std::vector<SearchResult> results(numThreads);
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        int iterations = config_.iterations / numThreads;
+        threads.emplace_back([&, t, iterations]() {
+            results[t] = search(root, seat, mix(seed, t), iterations);
+        });
+    }
+    results[0] = search(root, seat, seed, config_.iterations - (numThreads - 1) * (config_.iterations / numThreads));
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Every tree expands the same root, so children line up across threads
+    SearchResult& merged = results[0];
+    if (merged.actions.size() <= 1) {
+        return merged.actions.empty() ? DealDecision::hold() : merged.actions[0];
+    }
+    for (int t = 1; t < numThreads; ++t) {
+        for (size_t i = 0; i < merged.actions.size(); ++i) {
+            merged.visits[i] += results[t].visits[i];
+            merged.rewards[i] += results[t].rewards[i];
+        }
+    }
+
+    size_t best = 0;
+    for (size_t i = 1; i < merged.actions.size(); ++i) {
+        if (merged.visits[i] > merged.visits[best] ||
+            (merged.visits[i] == merged.visits[best] && merged.rewards[i] > merged.rewards[best])) {
+            best = i;
+        }
+    }
+    return merged.actions[best];
+}
+
+MctsStrategy::SearchResult MctsStrategy::search(const GameState& root, int seat,
+                                                std::uint64_t seed, int iterations) const {
+    Rng rng(seed);
+    Game scratch(root);
+
+    std::vector<Node> tree(1);
+    expand(tree, 0, scratch);
+
+    SearchResult result;
+    if (tree[0].numChildren > 1) {
+        auto start = std::chrono::steady_clock::now();
+        for (int iteration = 0;; ++iteration) {
+            if (config_.timeBudgetMs > 0.0) {
+                // Checking the clock every iteration would cost more than the rollouts
+                if ((iteration & 15) == 0) {
+                    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                    if (elapsed.count() >= config_.timeBudgetMs) break;
+                }
+            } else if (iteration >= iterations) {
+                break;
+            }
+
+            GameState state = root;
+            determinize(state, seat, rng);
+            scratch.restore(state);
+
+            int node = 0;
+            for (;;) {
+                if (!tree[node].expanded) expand(tree, node, scratch);
+                if (tree[node].numChildren == 0) break; // No deals left
+
+                node = selectChild(tree, node);
+                DealDecision action = tree[node].action;
+                if (action.kind == DealDecision::Kind::HOLD) break;
+                scratch.applyDeal(action);
+            }
+
+            // Rest of the game with the greedy policy for everyone
+            scratch.endTurn();
+            while (!scratch.isFinished()) {
+                scratch.playNextTurn();
+            }
+
+            double value = reward(scratch, seat);
+            for (int n = node; n != -1; n = tree[n].parent) {
+                tree[n].visits++;
+                tree[n].totalReward += value;
+            }
+        }
+    }
+
+    for (int i = 0; i < tree[0].numChildren; ++i) {
+        const Node& child = tree[tree[0].firstChild + i];
+        result.actions.push_back(child.action);
+        result.visits.push_back(child.visits);
+        result.rewards.push_back(child.totalReward);
+    }
+    return result;
+}
+
+void MctsStrategy::expand(std::vector<Node>& tree, int nodeIndex, const Game& game) const {
+    tree[nodeIndex].expanded = true;
+    if (game.getDealsRemaining() <= 0) return;
+
+    const Player& player = game.getPlayers()[game.getCurrentSeat()];
+    std::vector<DealDecision> actions;
+    actions.push_back(DealDecision::hold());
+
+    const auto& contracts = player.getContracts();
+    for (size_t i = 0; i < contracts.size(); ++i) {
+        for (CardMask cards = player.getHandMask() & contracts[i]->getFrontier(); cards; cards &= cards - 1) {
+            actions.push_back(DealDecision::extend(static_cast<int>(i), Card::fromIndex(lowestBitIndex(cards))));
+        }
+    }
+
+    auto candidates = player.findContractShapes();
+    int numCandidates = std::min<int>(candidates.size(), config_.maxSignCandidates);
+    for (int i = 0; i < numCandidates; ++i) {
+        actions.push_back(DealDecision::sign(candidates[i]));
+    }
+
+    tree[nodeIndex].firstChild = static_cast<int>(tree.size());
+    tree[nodeIndex].numChildren = static_cast<int>(actions.size());
+    for (auto& action : actions) {
+        Node child;
+        child.action = std::move(action);
+        child.parent = nodeIndex;
+        tree.push_back(std::move(child));
+    }
+}
+
+int MctsStrategy::selectChild(const std::vector<Node>& tree, int nodeIndex) const {
+    const Node& parent = tree[nodeIndex];
+    double logVisits = std::log(static_cast<double>(std::max(1, parent.visits)));
+
+    int best = parent.firstChild;
+    double bestScore = -1.0;
+    for (int i = parent.firstChild; i < parent.firstChild + parent.numChildren; ++i) {
+        const Node& child = tree[i];
+        if (child.visits == 0) return i;
+
+        double score = child.totalReward / child.visits
+                     + config_.exploration * std::sqrt(logVisits / child.visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+void MctsStrategy::determinize(GameState& state, int seat, Rng& rng) {
+    // Opponents' hands and the supply order are hidden; bazaar and contracts are public
+    std::uint8_t pool[kDeckSize];
+    int poolSize = 0;
+    for (int p = 0; p < state.numPlayers; ++p) {
+        if (p == seat) continue;
+        for (CardMask hand = state.hands[p]; hand; hand &= hand - 1) {
+            pool[poolSize++] = static_cast<std::uint8_t>(lowestBitIndex(hand));
+        }
+    }
+    for (int i = 0; i < state.supplySize; ++i) {
+        pool[poolSize++] = state.supply[i];
+    }
+    rng.shuffle(pool, pool + poolSize);
+
+    int next = 0;
+    for (int p = 0; p < state.numPlayers; ++p) {
+        if (p == seat) continue;
+        int handSize = popCount(state.hands[p]);
+        CardMask hand = 0;
+        for (int i = 0; i < handSize; ++i) {
+            hand |= CardMask(1) << pool[next++];
+        }
+        state.hands[p] = hand;
+    }
+    for (int i = 0; i < state.supplySize; ++i) {
+        state.supply[i] = pool[next++];
+    }
+}
+
+double MctsStrategy::reward(const Game& game, int seat) {
+    const auto& players = game.getPlayers();
+    int mine = players[seat].getTotalPoints();
+    int bestOther = 0;
+    for (int p = 0; p < (int)players.size(); ++p) {
+        if (p != seat) bestOther = std::max(bestOther, players[p].getTotalPoints());
+    }
+
+    // Half for winning, half for the margin so close losses still steer the search
+    double win = &game.getWinner() == &players[seat] ? 1.0 : 0.0;
+    double margin = std::min(1.0, std::max(0.0, 0.5 + (mine - bestOther) / 40.0));
+    return 0.5 * win + 0.5 * margin;
+}
@@ -0,0 +1,58 @@
+#ifndef MCTS_STRATEGY_H
+#define MCTS_STRATEGY_H
+
+#include "Strategy.h"
+#include "GameState.h"
+#include "Rng.h"
+#include <cstdint>
+#include <vector>
+
+struct MctsConfig {
+    int iterations = 400;        // Per deal decision, split across threads
+    double timeBudgetMs = 0.0;   // When > 0, search until this much time has passed instead
+    int threads = 1;             // Independent root-parallel trees
+    int maxSignCandidates = 8;   // Most efficient contract shapes considered per node
+    double exploration = 0.7;    // UCT exploration constant
+    std::uint64_t seed = 1;
+};
+
+// Information-set Monte Carlo tree search over one player's deal phase.
+// Each iteration re-deals the cards the player cannot see (opponents' hands
+// and the supply order), walks the tree of sign/extend/hold choices for the
+// rest of this deal phase, then plays the game out with the greedy policy.
+class MctsStrategy : public Strategy {
+public:
+    explicit MctsStrategy(const MctsConfig& config = MctsConfig());
+
+    DealDecision chooseDeal(const Game& game, const Player& player) override;
+
+    const MctsConfig& getConfig() const { return config_; }
+
+private:
+    struct Node {
+        DealDecision action;
+        int parent = -1;
+        int firstChild = -1;
+        int numChildren = 0;
+        bool expanded = false;
+        int visits = 0;
+        double totalReward = 0.0;
+    };
+
+    struct SearchResult {
+        std::vector<DealDecision> actions;
+        std::vector<int> visits;
+        std::vector<double> rewards;
+    };
+
+    MctsConfig config_;
+
+    SearchResult search(const GameState& root, int seat, std::uint64_t seed, int iterations) const;
+    void expand(std::vector<Node>& tree, int nodeIndex, const Game& game) const;
+    int selectChild(const std::vector<Node>& tree, int nodeIndex) const;
+
+    static void determinize(GameState& state, int seat, Rng& rng);
+    static double reward(const Game& game, int seat);
+};
+
+#endif
@@ -0,0 +1,267 @@
+#include "PartitionSolver.h"
+#include "ContractUniverse.h"
+#include "Game.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+constexpr int kMaxKeyDeals = 31;
+
+int highestBitIndex(std::uint32_t bits) {
+    int index = 0;
+    while (bits >>= 1) ++index;
+    return index;
+}
+
+// Every way of taking one card from each rank in `ranks` (a 13-bit mask)
+template <typename Visit>
+void forEachRankFill(CardMask hand, std::uint32_t ranks, CardMask chosen, Visit& visit) {
+    if (!ranks) {
+        visit(chosen);
+        return;
+    }
+    int rank = lowestBitIndex(ranks);
+    for (CardMask column = hand & rankColumn(rank); column; column &= column - 1) {
+        forEachRankFill(hand, ranks & (ranks - 1), chosen | (column & (~column + 1)), visit);
+    }
+}
+
+// Calls visit(type, cards) for every valid contract inside `hand` that uses `card`
+template <typename Visit>
+void forEachContractContaining(CardMask hand, int card, Visit visit) {
+    int suit = card / kRanksPerSuit;
+    int rank = card % kRanksPerSuit;
+    int base = suit * kRanksPerSuit;
+    CardMask cardBit = CardMask(1) << card;
+    std::uint32_t lane = suitLane(hand, suit);
+    std::uint32_t ranks = rankUnion(hand);
+
+    // Partnerships: the card plus 2-6 others of its suit
+    std::uint32_t others = lane & ~(1u << rank);
+    if (popCount(others) >= 2) {
+        for (std::uint32_t subset = others; subset; subset = (subset - 1) & others) {
+            int size = popCount(subset) + 1;
+            if (size >= 3 && size <= ContractUniverse::kMaxSize) {
+                visit(ContractType::PARTNERSHIP, cardBit | (CardMask(subset) << base));
+            }
+        }
+    }
+
+    // Monopolies: the card plus 2 or 3 others of its rank
+    CardMask column = hand & rankColumn(rank) & ~cardBit;
+    if (popCount(column) >= 2) {
+        for (CardMask subset = column; subset; subset = (subset - 1) & column) {
+            if (popCount(subset) >= 2) {
+                visit(ContractType::MONOPOLY, cardBit | subset);
+            }
+        }
+    }
+
+    // Runs through the card's rank, as Silk Roads in its suit and Trade Routes in any suits
+    auto visitRun = [&](std::uint32_t window) {
+        if ((lane & window) == window) {
+            visit(ContractType::SILK_ROAD, CardMask(window) << base);
+        }
+        if ((ranks & window) == window) {
+            auto fill = [&](CardMask cards) { visit(ContractType::TRADE_ROUTE, cards); };
+            forEachRankFill(hand, window & ~(1u << rank), cardBit, fill);
+        }
+    };
+    for (int start = std::max(0, rank - ContractUniverse::kMaxSize + 1); start <= rank; ++start) {
+        for (int len = std::max(3, rank - start + 1); len <= ContractUniverse::kMaxSize && start + len <= kRanksPerSuit; ++len) {
+            std::uint32_t window = ((1u << len) - 1) << start;
+            if ((ranks & window) != window) break; // Longer windows from here have the same gap
+            visitRun(window);
+        }
+    }
+    if (kWrapRun & (1u << rank)) {
+        visitRun(kWrapRun);
+    }
+}
+
+// Ways to grow an existing contract with cards from the hand
+template <typename Visit>
+void forEachExtension(const Contract& contract, CardMask contractCards, CardMask hand, Visit visit) {
+    int size = contract.getSize();
+    int room = ContractUniverse::kMaxSize - size;
+    if (room <= 0) return;
+
+    switch (contract.getType()) {
+        case ContractType::PARTNERSHIP: {
+            int suit = lowestBitIndex(contractCards) / kRanksPerSuit;
+            std::uint32_t lane = suitLane(hand, suit);
+            for (std::uint32_t subset = lane; subset; subset = (subset - 1) & lane) {
+                if (popCount(subset) <= room) {
+                    visit(CardMask(subset) << (suit * kRanksPerSuit));
+                }
+            }
+            break;
+        }
+        case ContractType::MONOPOLY: {
+            CardMask fourth = hand & rankColumn(lowestBitIndex(contractCards) % kRanksPerSuit);
+            if (fourth && size == 3) visit(fourth);
+            break;
+        }
+        case ContractType::SILK_ROAD:
+        case ContractType::TRADE_ROUTE: {
+            std::uint32_t run = rankUnion(contractCards);
+            if (run == kWrapRun) break; // Q-K-A cannot grow
+            int low = lowestBitIndex(run);
+            int high = highestBitIndex(run);
+            bool silk = contract.getType() == ContractType::SILK_ROAD;
+            int suit = lowestBitIndex(contractCards) / kRanksPerSuit;
+            CardMask source = silk ? (CardMask(suitLane(hand, suit)) << (suit * kRanksPerSuit)) : hand;
+            std::uint32_t available = rankUnion(source);
+
+            for (int below = 0; below <= room && low - below >= 0; ++below) {
+                if (below > 0 && !(available & (1u << (low - below)))) break;
+                for (int above = 0; below + above <= room && high + above < kRanksPerSuit; ++above) {
+                    if (above > 0 && !(available & (1u << (high + above)))) break;
+                    if (below + above == 0) continue;
+                    std::uint32_t added = (((1u << below) - 1) << (low - below))
+                                        | (((1u << above) - 1) << (high + 1));
+                    forEachRankFill(source, added, 0, visit);
+                }
+            }
+            break;
+        }
+    }
+}
+
+}
+
+PartitionSolver::PartitionSolver(int memoBits) : memo_(memoBits) {}
+
+PartitionSolver& PartitionSolver::shared() {
+    static PartitionSolver solver;
+    return solver;
+}
+
+int PartitionSolver::bestNewContracts(CardMask hand, int deals) const {
+    return search(hand, deals);
+}
+
+int PartitionSolver::search(CardMask hand, int deals) const {
+    int count = popCount(hand);
+    deals = std::min({deals, count / 3, kMaxKeyDeals});
+    if (deals <= 0) return 0;
+
+    std::uint64_t key = hand | (std::uint64_t(deals) << kDeckSize);
+    std::uint64_t stored;
+    if (memo_.probe(key, stored)) return static_cast<int>(stored);
+
+    // Either the lowest card sits out, or it belongs to one of the contracts
+    int card = lowestBitIndex(hand);
+    int best = search(hand & (hand - 1), deals);
+    forEachContractContaining(hand, card, [&](ContractType type, CardMask cards) {
+        int points = Contract::calculatePoints(type, popCount(cards)) + search(hand & ~cards, deals - 1);
+        best = std::max(best, points);
+    });
+
+    memo_.store(key, static_cast<std::uint64_t>(best));
+    return best;
+}
+
+void PartitionSolver::planNewContracts(CardMask hand, int deals, std::vector<DealDecision>& steps) const {
+    for (;;) {
+        int value = search(hand, deals);
+        if (value == 0) return;
+
+        int card = lowestBitIndex(hand);
+        if (search(hand & (hand - 1), deals) == value) {
+            hand &= hand - 1;
+            continue;
+        }
+
+        bool found = false;
+        forEachContractContaining(hand, card, [&](ContractType type, CardMask cards) {
+            if (found) return;
+            if (Contract::calculatePoints(type, popCount(cards)) + search(hand & ~cards, deals - 1) == value) {
+                steps.push_back(DealDecision::sign(type, cards));
+                hand &= ~cards;
+                found = true;
+            }
+        });
+        if (!found) return; // Only reachable if the memo was overwritten mid-plan by an inconsistent entry
+        deals--;
+    }
+}
+
+DealPlan PartitionSolver::solve(const Player& player, int deals) const {
+    const auto& contracts = player.getContracts();
+    std::vector<CardMask> masks;
+    for (const auto& contract : contracts) {
+        masks.push_back(contract->getCardMask());
+    }
+
+    // Search extension choices contract by contract, then fill with new contracts
+    std::vector<CardMask> chosen(contracts.size(), 0);
+    std::vector<CardMask> best(contracts.size(), 0);
+    int bestPoints = -1;
+    CardMask bestRemaining = 0;
+    int bestDeals = 0;
+
+    auto recurse = [&](auto& self, size_t index, CardMask hand, int dealsLeft, int gained) -> void {
+        if (index == contracts.size() || dealsLeft == 0) {
+            int total = gained + search(hand, dealsLeft);
+            if (total > bestPoints) {
+                bestPoints = total;
+                best = chosen;
+                bestRemaining = hand;
+                bestDeals = dealsLeft;
+            }
+            return;
+        }
+
+        chosen[index] = 0;
+        self(self, index + 1, hand, dealsLeft, gained);
+
+        const Contract& contract = *contracts[index];
+        forEachExtension(contract, masks[index], hand, [&](CardMask added) {
+            int count = popCount(added);
+            if (count > dealsLeft) return;
+            int gain = Contract::calculatePoints(contract.getType(), contract.getSize() + count) - contract.getPoints();
+            if (gain <= 0) return;
+            chosen[index] = added;
+            self(self, index + 1, hand & ~added, dealsLeft - count, gained + gain);
+            chosen[index] = 0;
+        });
+    };
+    recurse(recurse, 0, player.getHandMask(), deals, 0);
+
+    DealPlan plan;
+    plan.points = bestPoints;
+    for (size_t i = 0; i < contracts.size(); ++i) {
+        if (!best[i]) continue;
+
+        // Runs grow outward from their ends, so add the nearest ranks first
+        std::uint32_t run = rankUnion(masks[i]);
+        int low = lowestBitIndex(run);
+        std::vector<Card> added = cardsFromMask(best[i]);
+        std::sort(added.begin(), added.end(), [low](const Card& a, const Card& b) {
+            int distanceA = std::abs(a.getRankValue() - 1 - low);
+            int distanceB = std::abs(b.getRankValue() - 1 - low);
+            bool belowA = a.getRankValue() - 1 < low;
+            bool belowB = b.getRankValue() - 1 < low;
+            if (belowA != belowB) return belowA;
+            return distanceA < distanceB;
+        });
+        for (const auto& card : added) {
+            plan.steps.push_back(DealDecision::extend(static_cast<int>(i), card));
+        }
+    }
+    planNewContracts(bestRemaining, bestDeals, plan.steps);
+    return plan;
+}
+
+SolverStrategy::SolverStrategy(const PartitionSolver& solver) : solver_(solver) {}
+
+DealDecision SolverStrategy::chooseDeal(const Game& game, const Player& player) {
+    // Re-solving after every deal is cheap: the remaining hands are already memoized
+    DealPlan plan = solver_.solve(player, game.getDealsRemaining());
+    if (plan.steps.empty()) {
+        return DealDecision::hold();
+    }
+    return plan.steps.front();
+}
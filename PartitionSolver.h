@@ -0,0 +1,50 @@
+#ifndef PARTITION_SOLVER_H
+#define PARTITION_SOLVER_H
+
+#include "Strategy.h"
+#include "TranspositionTable.h"
+#include <cstdint>
+#include <vector>
+
+// Best use of a deal phase: the extensions and new contracts, in a legal order
+struct DealPlan {
+    int points = 0;                    // Points gained by following the plan
+    std::vector<DealDecision> steps;   // One deal each
+};
+
+// Finds the set of disjoint new contracts and extensions of existing contracts
+// that scores the most points with a limited number of deals. New contracts are
+// solved by dynamic programming over hand masks; the memo is a fixed-size
+// lock-free table, so one solver can be shared by every game and thread.
+class PartitionSolver {
+public:
+    explicit PartitionSolver(int memoBits = 20);
+
+    DealPlan solve(const Player& player, int deals) const;
+
+    // Most points from at most `deals` disjoint new contracts inside `hand`
+    int bestNewContracts(CardMask hand, int deals) const;
+
+    static PartitionSolver& shared();
+
+private:
+    // Keyed by hand mask and deal count; filling it in is not an observable change
+    mutable TranspositionTable memo_;
+
+    int search(CardMask hand, int deals) const;
+
+    void planNewContracts(CardMask hand, int deals, std::vector<DealDecision>& steps) const;
+};
+
+// Plays each deal phase by the solver's plan
+class SolverStrategy : public Strategy {
+public:
+    explicit SolverStrategy(const PartitionSolver& solver = PartitionSolver::shared());
+
+    DealDecision chooseDeal(const Game& game, const Player& player) override;
+
+private:
+    const PartitionSolver& solver_;
+};
+
+#endif
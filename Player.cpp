@@ -1,53 +1,220 @@
 #include "Player.h"
+#include "ContractUniverse.h"
+#include "Profiler.h"
 #include <algorithm>
-#include <map>
 #include <sstream>
 
-Player::Player(int id) : id_(id) {}
+namespace {
+
+// Equally efficient candidates differ only in which cards they use;
+// the lowest mask spends the lowest ranks and suits first
+bool bestCandidateFirst(const Player::PossibleContract& a, const Player::PossibleContract& b) {
+    if (a.efficiency != b.efficiency) return a.efficiency > b.efficiency;
+    return a.mask < b.mask;
+}
+
+}
+
+Player::Player(int id) : id_(id), hand_(0), handHash_(0) {
+    contracts_.reserve(kMaxContractsPerGame);
+    
+    // Shape lanes are sized for the fullest hand up front, so play never grows them
+    constexpr int kSizes = ContractUniverse::kMaxSize - ContractUniverse::kMinSize + 1;
+    for (auto& lane : candidates_.suits) lane.slots.reserve(kTradeRouteSlots * kSizes + kSizes);
+    for (auto& lane : candidates_.tradeRoutes) lane.slots.reserve(kSizes);
+    for (auto& lane : candidates_.ranks) lane.slots.reserve(kNumSuits - ContractUniverse::kMinSize + 1);
+}
 
 void Player::addCard(const Card& card) {
-    hand_.push_back(card);
+    hand_ |= card.getMask();
+    handHash_ ^= kZobrist.hand[id_ - 1][card.getIndex()];
+    markDirty(card);
 }
 
 void Player::removeCard(const Card& card) {
-    auto it = std::find(hand_.begin(), hand_.end(), card);
-    if (it != hand_.end()) {
-        hand_.erase(it);
+    hand_ &= ~card.getMask();
+    handHash_ ^= kZobrist.hand[id_ - 1][card.getIndex()];
+    markDirty(card);
+}
+
+void Player::removeCards(CardMask cards) {
+    hand_ &= ~cards;
+    for (; cards; cards &= cards - 1) {
+        int index = lowestBitIndex(cards);
+        handHash_ ^= kZobrist.hand[id_ - 1][index];
+        markDirty(Card::fromIndex(index));
+    }
+}
+
+void Player::setHand(CardMask hand) {
+    hand_ = hand;
+    handHash_ = 0;
+    for (; hand; hand &= hand - 1) {
+        handHash_ ^= kZobrist.hand[id_ - 1][lowestBitIndex(hand)];
     }
+    markAllDirty();
 }
 
-void Player::addContract(std::shared_ptr<Contract> contract) {
-    contracts_.push_back(contract);
+void Player::markAllDirty() {
+    std::uint32_t suits = (1u << kNumSuits) - 1;
+    std::uint32_t tradeRoutes = (1u << kTradeRouteSlots) - 1;
+    std::uint32_t ranks = (1u << kRanksPerSuit) - 1;
+    candidates_.markDirty(suits, tradeRoutes, ranks);
+    everyCandidate_.markDirty(suits, tradeRoutes, ranks);
 }
 
-int Player::getTotalPoints() const {
-    int total = 0;
-    for (const auto& contract : contracts_) {
-        total += contract->getPoints();
+void Player::markDirty(const Card& card) {
+    int rank = card.getRankValue() - 1;
+    std::uint32_t suits = 1u << static_cast<int>(card.getSuit());
+    std::uint32_t ranks = 1u << rank;
+    
+    // Routes starting up to six ranks below this one pass through it
+    std::uint32_t tradeRoutes = 0;
+    int first = std::max(0, rank - 6);
+    int last = std::min(kWrapSlot - 1, rank);
+    if (first <= last) {
+        tradeRoutes |= ((1u << (last - first + 1)) - 1) << first;
+    }
+    if (kWrapRun & (1u << rank)) {
+        tradeRoutes |= 1u << kWrapSlot;
     }
-    return total;
+    candidates_.markDirty(suits, tradeRoutes, ranks);
+    everyCandidate_.markDirty(suits, tradeRoutes, ranks);
 }
 
-int Player::getTotalSupplyBonus() const {
-    int total = 0;
-    for (const auto& contract : contracts_) {
-        total += contract->getSupplyBonus();
+void Player::refreshCandidates(CandidateIndex& index, bool everyChoice) const {
+    auto rescan = [](std::uint32_t& dirty, auto& lists, auto find) {
+        while (dirty) {
+            int lane = lowestBitIndex(dirty);
+            dirty &= dirty - 1;
+            CandidateLane& list = lists[lane];
+            list.size = 0;
+            find(lane, list);
+            PROFILE_COUNT(CANDIDATES_GENERATED, list.size);
+            if (list.size > 1) {
+                std::sort(list.slots.begin(), list.slots.begin() + list.size, bestCandidateFirst);
+            }
+        }
+    };
+    
+    rescan(index.dirtySuits, index.suits, [this, everyChoice](int suit, CandidateLane& out) {
+        findSilkRoads(suit, out);
+        if (everyChoice) {
+            findEveryPartnership(suit, out);
+        } else {
+            findPartnerships(suit, out);
+        }
+    });
+    rescan(index.dirtyTradeRoutes, index.tradeRoutes, [this, everyChoice](int slot, CandidateLane& out) {
+        if (everyChoice) {
+            findEveryTradeRoute(slot, out);
+        } else {
+            findTradeRoutes(slot, out);
+        }
+    });
+    rescan(index.dirtyRanks, index.ranks, [this, everyChoice](int rank, CandidateLane& out) {
+        if (everyChoice) {
+            findEveryMonopoly(rank, out);
+        } else {
+            findMonopolies(rank, out);
+        }
+    });
+}
+
+void Player::CandidateLane::append(ContractType type, CardMask cards) {
+    if (size == slots.size()) {
+        slots.emplace_back();
+    }
+    PossibleContract& candidate = slots[size++];
+    int cardCount = popCount(cards);
+    candidate.type = type;
+    candidate.mask = cards;
+    candidate.points = Contract::calculatePoints(type, cardCount);
+    candidate.efficiency = static_cast<double>(candidate.points) / cardCount;
+    
+    // Card order is rank order; only a Trade Route spans suits, one card per rank
+    candidate.cards.clear();
+    if (type == ContractType::TRADE_ROUTE) {
+        std::uint32_t ranks = rankUnion(cards);
+        for (; ranks; ranks &= ranks - 1) {
+            candidate.cards.push_back(Card::fromIndex(lowestBitIndex(cards & rankColumn(lowestBitIndex(ranks)))));
+        }
+    } else {
+        for (; cards; cards &= cards - 1) {
+            candidate.cards.push_back(Card::fromIndex(lowestBitIndex(cards)));
+        }
     }
-    return total;
 }
 
-int Player::getTotalDeals() const {
-    int total = 1; // Base deal
-    for (const auto& contract : contracts_) {
-        int bonus = contract->getBonusDeals();
-        if (bonus >= 999) return 999; // Unlimited
-        total += bonus;
+void Player::addContract(Contract& contract) {
+    contracts_.push_back(&contract);
+    tally(contract, 1);
+}
+
+void Player::extendContract(int index, const Card& card) {
+    Contract& contract = *contracts_[index];
+    tally(contract, -1);
+    contract.addCard(card);
+    tally(contract, 1);
+    removeCard(card);
+}
+
+void Player::clearContracts() {
+    contracts_.clear();
+    ledger_ = ScoreLedger();
+}
+
+void Player::tally(const Contract& contract, int sign) {
+    int size = sign * contract.getSize();
+    ledger_.points += sign * contract.getPoints();
+    ledger_.supplyBonus += sign * contract.getSupplyBonus();
+    
+    int bonusDeals = contract.getBonusDeals();
+    if (bonusDeals >= 999) {
+        ledger_.unlimitedDeals += sign;
+    } else {
+        ledger_.bonusDeals += sign * bonusDeals;
     }
-    return total;
+    
+    VoteBreakdown& votes = ledger_.votes;
+    int suit = lowestBitIndex(contract.getCardMask()) / kRanksPerSuit;
+    switch (contract.getType()) {
+        case ContractType::PARTNERSHIP:
+            votes.guildStanding[suit] += size;
+            // A Partnership whose cards happen to run still earns the mark
+            if (Contract::isRun(suitLane(contract.getCardMask(), suit))) {
+                votes.silkRoadMarks += sign;
+            }
+            break;
+        case ContractType::SILK_ROAD:
+            votes.guildStanding[suit] += size;
+            votes.caravanCapacity += size;
+            votes.silkRoadMarks += sign;
+            break;
+        case ContractType::TRADE_ROUTE:
+            votes.caravanCapacity += size;
+            break;
+        case ContractType::MONOPOLY:
+            votes.marketShare += size;
+            break;
+    }
+}
+
+std::uint64_t Player::getHash() const {
+    std::uint64_t hash = handHash_;
+    for (size_t i = 0; i < contracts_.size(); ++i) {
+        hash ^= zobristPlaceContract(contracts_[i]->getHash(), id_ - 1, static_cast<int>(i));
+    }
+    return hash;
+}
+
+int Player::getTotalDeals() const {
+    if (ledger_.unlimitedDeals > 0) return 999; // Unlimited
+    return 1 + ledger_.bonusDeals; // Base deal plus bonuses
 }
 
-std::vector<std::shared_ptr<Contract>> Player::getTradeRoutes() const {
-    std::vector<std::shared_ptr<Contract>> routes;
+std::vector<Contract*> Player::getTradeRoutes() const {
+    std::vector<Contract*> routes;
     for (const auto& contract : contracts_) {
         if (contract->hasTradeRights()) {
             routes.push_back(contract);
@@ -57,205 +224,213 @@ std::vector<std::shared_ptr<Contract>> Player::getTradeRoutes() const {
 }
 
 std::vector<Player::PossibleContract> Player::findPossibleContracts() const {
-    std::vector<PossibleContract> possible;
-    
-    findSilkRoads(possible);     // Check Silk Roads first (highest value)
-    findPartnerships(possible);
-    findTradeRoutes(possible);
-    findMonopolies(possible);
-    
-    std::sort(possible.begin(), possible.end());
-    return possible;
+    PROFILE_SCOPE(FIND_POSSIBLE_CONTRACTS);
+    refreshCandidates(everyCandidate_, true);
+    return mergeLanes(everyCandidate_);
+}
+
+std::vector<Player::PossibleContract> Player::findContractShapes() const {
+    refreshCandidates(candidates_, false);
+    return mergeLanes(candidates_);
 }
 
-void Player::findSilkRoads(std::vector<PossibleContract>& contracts) const {
-    if (hand_.size() < 3) return;
+std::vector<Player::PossibleContract> Player::mergeLanes(const CandidateIndex& index) {
+    // Each lane is sorted, so a heap of lane cursors merges them without a re-sort
+    struct Cursor {
+        const PossibleContract* next;
+        const PossibleContract* end;
+    };
+    Cursor cursors[kNumSuits + kTradeRouteSlots + kRanksPerSuit];
+    int open = 0;
+    size_t total = 0;
+    auto gather = [&](const auto& lists) {
+        for (const auto& list : lists) {
+            if (list.size == 0) continue;
+            cursors[open++] = {list.begin(), list.end()};
+            total += list.size;
+        }
+    };
+    gather(index.suits);
+    gather(index.tradeRoutes);
+    gather(index.ranks);
     
-    // Group cards by suit
-    std::map<Suit, std::vector<Card>> bySuit;
-    for (const auto& card : hand_) {
-        bySuit[card.getSuit()].push_back(card);
+    auto later = [](const Cursor& a, const Cursor& b) { return bestCandidateFirst(*b.next, *a.next); };
+    std::make_heap(cursors, cursors + open, later);
+    std::vector<PossibleContract> merged;
+    merged.reserve(total);
+    while (open > 0) {
+        std::pop_heap(cursors, cursors + open, later);
+        Cursor& cursor = cursors[open - 1];
+        merged.push_back(*cursor.next);
+        if (++cursor.next == cursor.end) {
+            --open;
+        } else {
+            std::push_heap(cursors, cursors + open, later);
+        }
     }
+    return merged;
+}
+
+void Player::findSilkRoads(int suit, CandidateLane& contracts) const {
+    std::uint32_t lane = suitLane(hand_, suit);
+    if (!(lane & (lane >> 1) & (lane >> 2)) && (lane & kWrapRun) != kWrapRun) return;
     
-    // For each suit, find sequences
-    for (const auto& [suit, cards] : bySuit) {
-        if (cards.size() < 3) continue;
-        
-        std::vector<Card> sortedCards = cards;
-        std::sort(sortedCards.begin(), sortedCards.end(), 
-            [](const Card& a, const Card& b) { return a.getRankValue() < b.getRankValue(); });
-        
-        // Find all sequences of length 3-7
-        for (size_t start = 0; start < sortedCards.size(); ++start) {
-            for (size_t len = 3; len <= std::min(size_t(7), sortedCards.size() - start); ++len) {
-                std::vector<Card> sequence;
-                for (size_t i = start; i < start + len; ++i) {
-                    sequence.push_back(sortedCards[i]);
-                }
-                
-                if (Contract::isValidContract(ContractType::SILK_ROAD, sequence)) {
-                    int points = Contract::calculatePoints(ContractType::SILK_ROAD, len);
-                    contracts.push_back({ContractType::SILK_ROAD, sequence, points, 
-                                        static_cast<double>(points) / len});
-                }
-            }
+    for (const auto& runs : kContractUniverse.runs) {
+        // Shortest first, so once one run is missing every longer one is too
+        for (std::uint32_t run : runs) {
+            if ((run & lane) != run) break;
+            contracts.append(ContractType::SILK_ROAD, laneToMask(run, suit));
         }
     }
 }
 
-void Player::findPartnerships(std::vector<PossibleContract>& contracts) const {
-    if (hand_.size() < 3) return;
+void Player::findPartnerships(int suit, CandidateLane& contracts) const {
+    std::uint32_t lane = suitLane(hand_, suit);
+    int count = std::min(popCount(lane), ContractUniverse::kMaxSize);
     
-    std::map<Suit, std::vector<Card>> bySuit;
-    for (const auto& card : hand_) {
-        bySuit[card.getSuit()].push_back(card);
+    // The lowest ranks of each size stand for every partnership of that size
+    std::uint32_t ranks = 0;
+    for (int size = 1; size <= count; ++size) {
+        ranks |= lane & (~lane + 1);
+        lane &= lane - 1;
+        if (size >= ContractUniverse::kMinSize) {
+            contracts.append(ContractType::PARTNERSHIP, laneToMask(ranks, suit));
+        }
     }
+}
+
+void Player::findTradeRoutes(int slot, CandidateLane& contracts) const {
+    std::uint32_t ranks = rankUnion(hand_);
     
-    for (const auto& [suit, cards] : bySuit) {
-        if (cards.size() >= 3) {
-            for (size_t len = 3; len <= std::min(size_t(7), cards.size()); ++len) {
-                std::vector<Card> partnership(cards.begin(), cards.begin() + len);
-                int points = Contract::calculatePoints(ContractType::PARTNERSHIP, len);
-                contracts.push_back({ContractType::PARTNERSHIP, partnership, points,
-                                    static_cast<double>(points) / len});
-            }
+    // The lowest suit holding each rank stands for every choice of cards
+    for (std::uint32_t run : kContractUniverse.runs[slot]) {
+        if ((run & ranks) != run) break;
+        CardMask cards = 0;
+        for (std::uint32_t bits = run; bits; bits &= bits - 1) {
+            CardMask column = hand_ & rankColumn(lowestBitIndex(bits));
+            cards |= column & (~column + 1);
         }
+        contracts.append(ContractType::TRADE_ROUTE, cards);
     }
 }
 
-void Player::findTradeRoutes(std::vector<PossibleContract>& contracts) const {
-    if (hand_.size() < 3) return;
-    
-    std::vector<Card> sortedHand = hand_;
-    std::sort(sortedHand.begin(), sortedHand.end(),
-        [](const Card& a, const Card& b) { return a.getRankValue() < b.getRankValue(); });
-    
-    // Find sequences
-    for (size_t start = 0; start < sortedHand.size(); ++start) {
-        for (size_t len = 3; len <= std::min(size_t(7), sortedHand.size() - start); ++len) {
-            std::vector<Card> sequence;
-            for (size_t i = start; i < start + len; ++i) {
-                sequence.push_back(sortedHand[i]);
-            }
-            
-            if (Contract::isValidContract(ContractType::TRADE_ROUTE, sequence)) {
-                int points = Contract::calculatePoints(ContractType::TRADE_ROUTE, len);
-                contracts.push_back({ContractType::TRADE_ROUTE, sequence, points,
-                                    static_cast<double>(points) / len});
+void Player::findMonopolies(int rank, CandidateLane& contracts) const {
+    if (popCount(hand_ & rankColumn(rank)) < ContractUniverse::kMinSize) return;
+    std::uint32_t suits = suitsAtRank(rank);
+    for (int size = ContractUniverse::kMinSize; size <= popCount(suits); ++size) {
+        // The first match is the lowest suits
+        for (std::uint32_t shape : kContractUniverse.monopolies[size]) {
+            if ((shape & suits) == shape) {
+                contracts.append(ContractType::MONOPOLY, suitsToMask(shape, rank));
+                break;
             }
         }
     }
 }
 
-void Player::findMonopolies(std::vector<PossibleContract>& contracts) const {
-    if (hand_.size() < 3) return;
-    
-    std::map<Rank, std::vector<Card>> byRank;
-    for (const auto& card : hand_) {
-        byRank[card.getRank()].push_back(card);
-    }
+void Player::findEveryPartnership(int suit, CandidateLane& contracts) const {
+    std::uint32_t lane = suitLane(hand_, suit);
+    int count = std::min(popCount(lane), ContractUniverse::kMaxSize);
     
-    for (const auto& [rank, cards] : byRank) {
-        if (cards.size() >= 3) {
-            for (size_t len = 3; len <= std::min(size_t(4), cards.size()); ++len) {
-                std::vector<Card> monopoly(cards.begin(), cards.begin() + len);
-                int points = Contract::calculatePoints(ContractType::MONOPOLY, len);
-                contracts.push_back({ContractType::MONOPOLY, monopoly, points,
-                                    static_cast<double>(points) / len});
+    for (int size = ContractUniverse::kMinSize; size <= count; ++size) {
+        for (std::uint32_t ranks : kContractUniverse.partnerships[size]) {
+            if (ranks > lane) break;
+            if ((ranks & lane) == ranks) {
+                contracts.append(ContractType::PARTNERSHIP, laneToMask(ranks, suit));
             }
         }
     }
 }
 
-Player::PossibleContract Player::selectBestContract() const {
-    auto possible = findPossibleContracts();
-    if (possible.empty()) {
-        return {ContractType::PARTNERSHIP, {}, 0, 0.0};
+void Player::findEveryTradeRoute(int slot, CandidateLane& contracts) const {
+    std::uint32_t ranks = rankUnion(hand_);
+    
+    for (std::uint32_t run : kContractUniverse.runs[slot]) {
+        if ((run & ranks) != run) break;
+        
+        // Every way of taking one card of each rank in the run
+        CardMask columns[ContractUniverse::kMaxSize];
+        CardMask choice[ContractUniverse::kMaxSize];
+        int length = 0;
+        for (std::uint32_t bits = run; bits; bits &= bits - 1) {
+            columns[length] = hand_ & rankColumn(lowestBitIndex(bits));
+            choice[length] = columns[length];
+            ++length;
+        }
+        for (;;) {
+            CardMask cards = 0;
+            for (int i = 0; i < length; ++i) {
+                cards |= choice[i] & (~choice[i] + 1);
+            }
+            contracts.append(ContractType::TRADE_ROUTE, cards);
+            
+            // Odometer step: move the first rank that has another card on to it
+            int i = 0;
+            while (i < length && !(choice[i] & (choice[i] - 1))) {
+                choice[i] = columns[i];
+                ++i;
+            }
+            if (i == length) break;
+            choice[i] &= choice[i] - 1;
+        }
     }
-    return possible[0];
 }
 
-bool Player::shouldExtendContract(std::shared_ptr<Contract> contract, const Card& card) const {
-    auto cards = contract->getCards();
-    cards.push_back(card);
-    
-    if (Contract::isValidContract(contract->getType(), cards)) {
-        int newPoints = Contract::calculatePoints(contract->getType(), cards.size());
-        int currentPoints = contract->getPoints();
-        return newPoints > currentPoints; // Only extend if we gain points
+void Player::findEveryMonopoly(int rank, CandidateLane& contracts) const {
+    if (popCount(hand_ & rankColumn(rank)) < ContractUniverse::kMinSize) return;
+    std::uint32_t suits = suitsAtRank(rank);
+    for (int size = ContractUniverse::kMinSize; size <= popCount(suits); ++size) {
+        for (std::uint32_t shape : kContractUniverse.monopolies[size]) {
+            if ((shape & suits) == shape) {
+                contracts.append(ContractType::MONOPOLY, suitsToMask(shape, rank));
+            }
+        }
     }
-    return false;
 }
 
-std::vector<Card> Player::selectCardsForTrade(int tradeCost, const std::vector<Card>& bazaar) const {
-    // Select lowest value cards to trade away
-    std::vector<Card> sorted = hand_;
-    std::sort(sorted.begin(), sorted.end(),
-        [](const Card& a, const Card& b) { return a.getRankValue() < b.getRankValue(); });
-
-    std::vector<Card> toTrade;
-    for (int i = 0; i < tradeCost && i < (int)sorted.size(); ++i) {
-        toTrade.push_back(sorted[i]);
+std::uint32_t Player::suitsAtRank(int rank) const {
+    std::uint32_t suits = 0;
+    for (int suit = 0; suit < kNumSuits; ++suit) {
+        suits |= static_cast<std::uint32_t>((hand_ >> (suit * kRanksPerSuit + rank)) & 1) << suit;
     }
-    return toTrade;
+    return suits;
 }
 
-Player::VoteBreakdown Player::calculateVoteBreakdown() const {
-    VoteBreakdown breakdown;
-    breakdown.guildStanding = {
-        {Suit::HEARTS, 0},
-        {Suit::DIAMONDS, 0},
-        {Suit::CLUBS, 0},
-        {Suit::SPADES, 0}
-    };
-
-    for (const auto& contract : contracts_) {
-        if (!contract) {
-            continue;
+const Player::PossibleContract* Player::selectBestContract() const {
+    PROFILE_SCOPE(SELECT_BEST_CONTRACT);
+    refreshCandidates(candidates_, false);
+    
+    // Each lane is sorted, so the best candidate is the best of the lane heads
+    const PossibleContract* best = nullptr;
+    auto consider = [&best](const auto& lists) {
+        for (const auto& list : lists) {
+            if (list.size > 0 && (!best || *list.begin() < *best)) {
+                best = list.begin();
+            }
         }
+    };
+    consider(candidates_.suits);
+    consider(candidates_.tradeRoutes);
+    consider(candidates_.ranks);
+    return best;
+}
 
-        auto type = contract->getType();
-        int size = contract->getSize();
-        const auto& cards = contract->getCards();
-
-        switch (type) {
-            case ContractType::PARTNERSHIP: {
-                if (!cards.empty()) {
-                    Suit suit = cards.front().getSuit();
-                    breakdown.guildStanding[suit] += size;
+bool Player::shouldExtendContract(const Contract& contract, const Card& card) const {
+    PROFILE_SCOPE(SHOULD_EXTEND_CONTRACT);
+    return (contract.getFrontier() & card.getMask()) != 0;
+}
 
-                    if (Contract::isValidContract(ContractType::SILK_ROAD, cards)) {
-                        breakdown.silkRoadMarks += 1;
-                    }
-                }
-                break;
-            }
-            case ContractType::SILK_ROAD: {
-                if (!cards.empty()) {
-                    Suit suit = cards.front().getSuit();
-                    breakdown.guildStanding[suit] += size;
-                }
-                breakdown.caravanCapacity += size;
-                breakdown.silkRoadMarks += 1;
-                break;
-            }
-            case ContractType::TRADE_ROUTE: {
-                breakdown.caravanCapacity += size;
-                break;
-            }
-            case ContractType::MONOPOLY: {
-                breakdown.marketShare += size;
-                break;
-            }
-        }
+CardMask Player::getExtensionCards() const {
+    CardMask frontiers = 0;
+    for (const Contract* contract : contracts_) {
+        frontiers |= contract->getFrontier();
     }
-
-    return breakdown;
+    return hand_ & frontiers;
 }
 
 std::string Player::toString() const {
     std::ostringstream oss;
-    oss << getName() << " - Hand: " << hand_.size() << " cards, "
+    oss << getName() << " - Hand: " << getHandSize() << " cards, "
         << contracts_.size() << " contracts, "
         << getTotalPoints() << " points";
     return oss.str();
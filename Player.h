@@ -3,10 +3,10 @@
 
 #include "Card.h"
 #include "Contract.h"
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
-#include <map>
 
 class Player {
 public:
@@ -18,23 +18,35 @@ public:
     // Hand management
     void addCard(const Card& card);
     void removeCard(const Card& card);
-    const std::vector<Card>& getHand() const { return hand_; }
-    int getHandSize() const { return hand_.size(); }
+    void removeCards(CardMask cards);
+    void setHand(CardMask hand);
+    bool hasCard(const Card& card) const { return (hand_ & card.getMask()) != 0; }
+    std::vector<Card> getHand() const { return cardsFromMask(hand_); }
+    CardMask getHandMask() const { return hand_; }
+    int getHandSize() const { return popCount(hand_); }
     
-    // Contract management
-    void addContract(std::shared_ptr<Contract> contract);
-    const std::vector<std::shared_ptr<Contract>>& getContracts() const { return contracts_; }
-    int getTotalPoints() const;
+    // Contract management; contracts are owned by the game's ContractPool.
+    // Contract's mutators are private to Player, so extendContract is the only
+    // way to grow one and the score ledger stays current.
+    void addContract(Contract& contract);
+    void extendContract(int index, const Card& card);  // Moves `card` from hand to the contract
+    void clearContracts();
+    const std::vector<Contract*>& getContracts() const { return contracts_; }
+    int getTotalPoints() const { return ledger_.points; }
+    
+    // Zobrist hash of the hand and contracts; the hand part is kept up to date per card
+    std::uint64_t getHash() const;
     
     // Benefits
-    int getTotalSupplyBonus() const;
+    int getTotalSupplyBonus() const { return ledger_.supplyBonus; }
     int getTotalDeals() const;
-    std::vector<std::shared_ptr<Contract>> getTradeRoutes() const;
+    std::vector<Contract*> getTradeRoutes() const;
     
     // AI Strategy
     struct PossibleContract {
         ContractType type;
-        std::vector<Card> cards;
+        ContractCards cards;  // Rank order
+        CardMask mask;
         int points;
         double efficiency; // points per card
 
@@ -44,30 +56,97 @@ public:
     };
 
     struct VoteBreakdown {
-        std::map<Suit, int> guildStanding;
+        std::array<int, kNumSuits> guildStanding{};  // Indexed by Suit
         int caravanCapacity = 0;
         int marketShare = 0;
         int silkRoadMarks = 0;
     };
 
+    // Every contract the hand could sign, every card choice of each shape, best first
     std::vector<PossibleContract> findPossibleContracts() const;
-    PossibleContract selectBestContract() const;
-    bool shouldExtendContract(std::shared_ptr<Contract> contract, const Card& card) const;
-    std::vector<Card> selectCardsForTrade(int tradeCost, const std::vector<Card>& bazaar) const;
+    // One contract per shape (type, size and run), best first: the choices a
+    // search needs, as the other card choices of a shape score the same
+    std::vector<PossibleContract> findContractShapes() const;
+    // Best candidate in hand, or nullptr if none; valid until the hand changes
+    const PossibleContract* selectBestContract() const;
+    // Whether `card` is on the contract's frontier (a legal, point-gaining extension)
+    bool shouldExtendContract(const Contract& contract, const Card& card) const;
+    // Hand cards that extend at least one of this player's contracts
+    CardMask getExtensionCards() const;
 
-    VoteBreakdown calculateVoteBreakdown() const;
+    const VoteBreakdown& getVoteBreakdown() const { return ledger_.votes; }
     
     std::string toString() const;
     
 private:
+    // Trade Routes are indexed by their lowest rank (Ace..Jack), plus one slot for Q-K-A
+    static constexpr int kTradeRouteSlots = kRanksPerSuit - 1;
+    static constexpr int kWrapSlot = kTradeRouteSlots - 1;
+    
+    // Candidates of one lane. Slots past `size` are kept, so a rescan
+    // refills them in place and never reallocates.
+    struct CandidateLane {
+        std::vector<PossibleContract> slots;
+        size_t size = 0;
+        
+        void append(ContractType type, CardMask cards);
+        const PossibleContract* begin() const { return slots.data(); }
+        const PossibleContract* end() const { return slots.data() + size; }
+    };
+    
+    // Candidates cached per lane, each lane sorted best first. Contracts of one
+    // shape (type, size and run) score the same whatever cards they use, so the
+    // shape index keeps only the lowest-mask choice of each; a second index keeps
+    // every choice. A card change only marks the lanes it touches in both: its
+    // suit, its rank, and the routes through its rank.
+    struct CandidateIndex {
+        std::array<CandidateLane, kNumSuits> suits;  // Silk Roads, Partnerships
+        std::array<CandidateLane, kTradeRouteSlots> tradeRoutes;
+        std::array<CandidateLane, kRanksPerSuit> ranks;  // Monopolies
+        std::uint32_t dirtySuits = (1u << kNumSuits) - 1;
+        std::uint32_t dirtyTradeRoutes = (1u << kTradeRouteSlots) - 1;
+        std::uint32_t dirtyRanks = (1u << kRanksPerSuit) - 1;
+        
+        void markDirty(std::uint32_t suits, std::uint32_t tradeRoutes, std::uint32_t ranks) {
+            dirtySuits |= suits;
+            dirtyTradeRoutes |= tradeRoutes;
+            dirtyRanks |= ranks;
+        }
+    };
+    
+    // Running totals over every contract, updated as contracts are added or extended
+    struct ScoreLedger {
+        int points = 0;
+        int supplyBonus = 0;
+        int bonusDeals = 0;
+        int unlimitedDeals = 0;  // Monopolies granting unlimited deals
+        VoteBreakdown votes;
+    };
+    
     int id_;
-    std::vector<Card> hand_;
-    std::vector<std::shared_ptr<Contract>> contracts_;
+    CardMask hand_;
+    std::uint64_t handHash_;
+    std::vector<Contract*> contracts_;
+    ScoreLedger ledger_;
+    mutable CandidateIndex candidates_;      // One card choice per shape
+    mutable CandidateIndex everyCandidate_;  // Every card choice, for findPossibleContracts
+    
+    void tally(const Contract& contract, int sign);  // Adds (+1) or removes (-1) a contract's share
+    void markDirty(const Card& card);
+    void markAllDirty();
+    void refreshCandidates(CandidateIndex& index, bool everyChoice) const;
+    static std::vector<PossibleContract> mergeLanes(const CandidateIndex& index);  // Every lane, best first
+    
+    void findSilkRoads(int suit, CandidateLane& contracts) const;
+    void findPartnerships(int suit, CandidateLane& contracts) const;
+    void findTradeRoutes(int slot, CandidateLane& contracts) const;
+    void findMonopolies(int rank, CandidateLane& contracts) const;
     
-    void findPartnerships(std::vector<PossibleContract>& contracts) const;
-    void findTradeRoutes(std::vector<PossibleContract>& contracts) const;
-    void findMonopolies(std::vector<PossibleContract>& contracts) const;
-    void findSilkRoads(std::vector<PossibleContract>& contracts) const;
+    // Every card choice of each shape, by subset tests against the ContractUniverse
+    void findEveryPartnership(int suit, CandidateLane& contracts) const;
+    void findEveryTradeRoute(int slot, CandidateLane& contracts) const;
+    void findEveryMonopoly(int rank, CandidateLane& contracts) const;
+    std::uint32_t suitsAtRank(int rank) const;  // 4-bit set of suits held at a rank
 };
 
 #endif
\ No newline at end of file
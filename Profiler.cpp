@@ -0,0 +1,87 @@
+#include "Profiler.h"
+#include <mutex>
+
+namespace {
+
+const char* const kZoneNames[ProfileData::kZones] = {
+    "supplyPhase",
+    "barterPhase",
+    "dealPhase",
+    "findPossibleContracts",
+    "selectBestContract",
+    "shouldExtendContract"
+};
+
+const char* const kCounterNames[ProfileData::kCounters] = {
+    "games",
+    "candidatesGenerated",
+    "contractsSigned",
+    "contractsExtended"
+};
+
+std::mutex g_finishedMutex;
+ProfileData g_finished;
+
+struct ThreadProfile {
+    ProfileData data;
+
+    ~ThreadProfile() {
+        std::lock_guard<std::mutex> lock(g_finishedMutex);
+        g_finished.merge(data);
+    }
+};
+
+thread_local ThreadProfile t_profile;
+
+}
+
+void ProfileData::merge(const ProfileData& other) {
+    for (int i = 0; i < kZones; ++i) {
+        calls[i] += other.calls[i];
+        cycles[i] += other.cycles[i];
+    }
+    for (int i = 0; i < kCounters; ++i) {
+        counters[i] += other.counters[i];
+    }
+}
+
+ProfileData& Profiler::local() {
+    return t_profile.data;
+}
+
+ProfileData Profiler::collect() {
+    std::lock_guard<std::mutex> lock(g_finishedMutex);
+    ProfileData total = g_finished;
+    total.merge(t_profile.data);
+    return total;
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(g_finishedMutex);
+    g_finished = ProfileData();
+    t_profile.data = ProfileData();
+}
+
+void Profiler::writeJson(std::ostream& out) {
+    ProfileData data = collect();
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    const char* clock = "rdtsc";
+#else
+    const char* clock = "steady_clock_ns";
+#endif
+
+    out << "{\n  \"clock\": \"" << clock << "\",\n  \"zones\": {\n";
+    for (int i = 0; i < ProfileData::kZones; ++i) {
+        double perCall = data.calls[i] ? static_cast<double>(data.cycles[i]) / data.calls[i] : 0.0;
+        out << "    \"" << kZoneNames[i] << "\": {\"calls\": " << data.calls[i]
+            << ", \"cycles\": " << data.cycles[i]
+            << ", \"cyclesPerCall\": " << perCall << "}"
+            << (i + 1 < ProfileData::kZones ? ",\n" : "\n");
+    }
+    out << "  },\n  \"counters\": {\n";
+    for (int i = 0; i < ProfileData::kCounters; ++i) {
+        out << "    \"" << kCounterNames[i] << "\": " << data.counters[i]
+            << (i + 1 < ProfileData::kCounters ? ",\n" : "\n");
+    }
+    out << "  }\n}\n";
+}
@@ -0,0 +1,103 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Hot-path counters and timers. Only builds with MERCHANT_EMPIRE_PROFILE defined
+// (make PROFILE=1) record anything; otherwise the macros below expand to nothing.
+
+enum class ProfileZone {
+    SUPPLY_PHASE,
+    BARTER_PHASE,
+    DEAL_PHASE,
+    FIND_POSSIBLE_CONTRACTS,
+    SELECT_BEST_CONTRACT,
+    SHOULD_EXTEND_CONTRACT,
+    COUNT
+};
+
+enum class ProfileCounter {
+    GAMES,
+    CANDIDATES_GENERATED,
+    CONTRACTS_SIGNED,
+    CONTRACTS_EXTENDED,
+    COUNT
+};
+
+struct ProfileData {
+    static constexpr int kZones = static_cast<int>(ProfileZone::COUNT);
+    static constexpr int kCounters = static_cast<int>(ProfileCounter::COUNT);
+
+    std::array<std::uint64_t, kZones> calls{};
+    std::array<std::uint64_t, kZones> cycles{};  // Inclusive of nested zones
+    std::array<std::uint64_t, kCounters> counters{};
+
+    void merge(const ProfileData& other);
+};
+
+class Profiler {
+public:
+    static constexpr bool enabled() {
+#ifdef MERCHANT_EMPIRE_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Each thread records into its own data, folded into a shared total when it exits
+    static ProfileData& local();
+    static ProfileData collect();  // Exited threads plus the calling one
+    static void reset();
+    static void writeJson(std::ostream& out);
+
+    // Time stamp counter where available, otherwise nanoseconds
+    static std::uint64_t now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileZone zone) : zone_(static_cast<int>(zone)), start_(Profiler::now()) {}
+    ~ProfileScope() {
+        ProfileData& data = Profiler::local();
+        data.calls[zone_]++;
+        data.cycles[zone_] += Profiler::now() - start_;
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    int zone_;
+    std::uint64_t start_;
+};
+
+#ifdef MERCHANT_EMPIRE_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(zone) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(ProfileZone::zone)
+#define PROFILE_COUNT(counter, amount) \
+    (Profiler::local().counters[static_cast<int>(ProfileCounter::counter)] += (amount))
+#else
+#define PROFILE_SCOPE(zone) ((void)0)
+#define PROFILE_COUNT(counter, amount) ((void)0)
+#endif
+
+#endif
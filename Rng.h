@@ -0,0 +1,87 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+inline std::uint64_t splitMix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// xoshiro256** with its 32-byte state derived directly from a (seed, stream)
+// pair, so game i of a batch is Rng(masterSeed, i) no matter which thread
+// plays it or how many games came before. Satisfies UniformRandomBitGenerator.
+class Rng {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Rng(std::uint64_t seed = 0, std::uint64_t stream = 0) { this->seed(seed, stream); }
+
+    void seed(std::uint64_t seed, std::uint64_t stream = 0) {
+        // Hash the stream first so neighbouring indices start far apart
+        std::uint64_t x = seed ^ splitMix64(stream ^ 0xD1B54A32D192ED03ULL);
+        for (auto& word : state_) {
+            x += 0x9E3779B97F4A7C15ULL;
+            word = splitMix64(x);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        std::uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        std::uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, range) by Lemire's multiply-shift, which rarely needs a division
+    std::uint32_t bounded(std::uint32_t range) {
+        std::uint64_t product = (operator()() >> 32) * range;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < range) {
+            std::uint32_t threshold = (0u - range) % range;
+            while (low < threshold) {
+                product = (operator()() >> 32) * range;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+    // Fisher-Yates over a random-access range
+    template <typename Iterator>
+    void shuffle(Iterator first, Iterator last) {
+        auto count = last - first;
+        for (auto i = count - 1; i > 0; --i) {
+            auto j = bounded(static_cast<std::uint32_t>(i + 1));
+            using std::swap;
+            swap(first[i], first[j]);
+        }
+    }
+
+    bool operator==(const Rng& other) const {
+        return state_[0] == other.state_[0] && state_[1] == other.state_[1] &&
+               state_[2] == other.state_[2] && state_[3] == other.state_[3];
+    }
+    bool operator!=(const Rng& other) const { return !(*this == other); }
+
+private:
+    std::uint64_t state_[4];
+
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+#endif
@@ -0,0 +1,338 @@
+#include "ServerTable.h"
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+
+const char* const kFieldNames[ServerTable::kViewFields] = {
+    "status", "seats", "round", "turn", "deals", "supply", "bazaar", "hand", "players", "winner"
+};
+
+const char* const kContractNames[] = {"partnership", "trade_route", "monopoly", "silk_road"};
+
+const char* seatKindName(ServerTable::SeatKind kind) {
+    switch (kind) {
+        case ServerTable::SeatKind::OPEN: return "open";
+        case ServerTable::SeatKind::HUMAN: return "human";
+        case ServerTable::SeatKind::AI: return "ai";
+    }
+    return "open";
+}
+
+std::uint64_t fnv1a(const char* data, size_t size) {
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+void appendCards(std::string& out, CardMask cards) {
+    out.push_back('[');
+    for (bool first = true; cards; cards &= cards - 1, first = false) {
+        if (!first) out.push_back(',');
+        out += std::to_string(lowestBitIndex(cards));
+    }
+    out.push_back(']');
+}
+
+// A client command: one flat JSON object of strings, integers and integer arrays
+struct Command {
+    std::string op;
+    std::string contract;
+    CardMask cards = 0;
+    int index = -1;
+    int card = -1;
+};
+
+class CommandParser {
+public:
+    CommandParser(const char* json, size_t size) : p_(json), end_(json + size) {}
+
+    // Returns an error message, or an empty string on success
+    std::string parse(Command& command) {
+        skipSpace();
+        if (!consume('{')) return "Expected a JSON object";
+        skipSpace();
+        if (consume('}')) return "";
+        for (;;) {
+            std::string key;
+            if (!parseString(key)) return "Expected a field name";
+            skipSpace();
+            if (!consume(':')) return "Expected ':'";
+            skipSpace();
+
+            if (key == "op" || key == "contract") {
+                if (!parseString(key == "op" ? command.op : command.contract)) return "Expected a string for " + key;
+            } else if (key == "index" || key == "card") {
+                if (!parseInt(key == "index" ? command.index : command.card)) return "Expected an integer for " + key;
+            } else if (key == "cards") {
+                if (!parseCards(command.cards)) return "Expected an array of card indices";
+            } else {
+                return "Unknown field " + key;
+            }
+
+            skipSpace();
+            if (consume('}')) break;
+            if (!consume(',')) return "Expected ',' or '}'";
+            skipSpace();
+        }
+        skipSpace();
+        return p_ == end_ ? "" : "Trailing characters after the command";
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+
+    void skipSpace() {
+        while (p_ < end_ && std::isspace(static_cast<unsigned char>(*p_))) ++p_;
+    }
+
+    bool consume(char c) {
+        if (p_ < end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    // Commands only need plain ASCII, so escapes are rejected rather than decoded
+    bool parseString(std::string& value) {
+        if (!consume('"')) return false;
+        const char* start = p_;
+        while (p_ < end_ && *p_ != '"') {
+            if (*p_ == '\\') return false;
+            ++p_;
+        }
+        if (p_ == end_) return false;
+        value.assign(start, p_ - start);
+        ++p_;
+        return true;
+    }
+
+    bool parseInt(int& value) {
+        auto result = std::from_chars(p_, end_, value);
+        if (result.ec != std::errc()) return false;
+        p_ = result.ptr;
+        return true;
+    }
+
+    bool parseCards(CardMask& cards) {
+        if (!consume('[')) return false;
+        skipSpace();
+        if (consume(']')) return true;
+        for (;;) {
+            int index;
+            if (!parseInt(index) || index < 0 || index >= kDeckSize) return false;
+            cards |= CardMask(1) << index;
+            skipSpace();
+            if (consume(']')) return true;
+            if (!consume(',')) return false;
+            skipSpace();
+        }
+    }
+};
+
+}
+
+ServerTable::ServerTable(std::uint64_t id, int numPlayers, std::uint64_t seed)
+    : id_(id), game_(numPlayers, seed, id), started_(false), turnOpen_(false) {
+    seats_.fill(SeatKind::OPEN);
+}
+
+int ServerTable::getHumanCount() const {
+    int count = 0;
+    for (int seat = 0; seat < game_.getNumPlayers(); ++seat) {
+        count += seats_[seat] == SeatKind::HUMAN;
+    }
+    return count;
+}
+
+int ServerTable::join() {
+    for (int seat = 0; seat < game_.getNumPlayers(); ++seat) {
+        if (seats_[seat] == SeatKind::OPEN) {
+            seats_[seat] = SeatKind::HUMAN;
+            if (getHumanCount() == game_.getNumPlayers()) start();
+            return seat;
+        }
+    }
+    return -1;
+}
+
+void ServerTable::leave(int seat) {
+    if (seat < 0 || seat >= game_.getNumPlayers()) return;
+    seats_[seat] = started_ ? SeatKind::AI : SeatKind::OPEN;
+    advance();
+}
+
+void ServerTable::start() {
+    if (started_) return;
+    started_ = true;
+    for (int seat = 0; seat < game_.getNumPlayers(); ++seat) {
+        if (seats_[seat] == SeatKind::OPEN) seats_[seat] = SeatKind::AI;
+    }
+    advance();
+}
+
+void ServerTable::closeTurn() {
+    game_.endTurn();
+    turnOpen_ = false;
+}
+
+void ServerTable::advance() {
+    while (started_ && !game_.isFinished()) {
+        if (!turnOpen_) {
+            game_.beginTurn();
+            turnOpen_ = true;
+        }
+        if (game_.getDealsRemaining() <= 0) {
+            closeTurn();
+            continue;
+        }
+
+        int seat = game_.getCurrentSeat();
+        if (seats_[seat] == SeatKind::HUMAN) return;
+
+        const Player& player = game_.getPlayers()[seat];
+        DealDecision decision = GreedyStrategy::instance().chooseDeal(game_, player);
+        if (decision.kind == DealDecision::Kind::HOLD) {
+            closeTurn();
+        } else {
+            game_.applyDeal(decision);
+        }
+    }
+}
+
+std::string ServerTable::handleCommand(int seat, const char* json, size_t size) {
+    Command command;
+    std::string error = CommandParser(json, size).parse(command);
+    if (!error.empty()) return error;
+
+    if (seat < 0) return "Spectators cannot play";
+    if (command.op == "start") {
+        start();
+        return "";
+    }
+    if (command.op != "hold" && command.op != "sign" && command.op != "extend") {
+        return "Unknown op " + command.op;
+    }
+    if (!started_) return "The table has not started";
+    if (game_.isFinished()) return "The game is over";
+    if (seat != game_.getCurrentSeat()) return "Not your turn";
+
+    if (command.op == "hold") {
+        closeTurn();
+    } else {
+        DealDecision decision;
+        if (command.op == "sign") {
+            int type = 0;
+            while (type < 4 && command.contract != kContractNames[type]) ++type;
+            if (type == 4) return "Unknown contract " + command.contract;
+            decision = DealDecision::sign(static_cast<ContractType>(type), command.cards);
+        } else {
+            if (command.card < 0 || command.card >= kDeckSize) return "Expected a card index";
+            decision = DealDecision::extend(command.index, Card::fromIndex(command.card));
+        }
+        try {
+            game_.applyDeal(decision);
+        } catch (const std::exception& e) {
+            return e.what();
+        }
+    }
+    advance();
+    return "";
+}
+
+bool ServerTable::writeView(int seat, ViewHashes& sent, std::string& out) const {
+    size_t messageStart = out.size();
+    out += "{\"type\":\"state\"";
+    bool changed = false;
+    const auto& players = game_.getPlayers();
+    int numPlayers = game_.getNumPlayers();
+    bool inPlay = started_ && !game_.isFinished();
+
+    for (int field = 0; field < kViewFields; ++field) {
+        size_t fieldStart = out.size();
+        out += ",\"";
+        out += kFieldNames[field];
+        out += "\":";
+        switch (field) {
+            case 0:
+                out += !started_ ? "\"waiting\""
+                     : game_.getPhase() == GamePhase::MAIN ? "\"playing\""
+                     : game_.getPhase() == GamePhase::FINAL_ROUND ? "\"final\"" : "\"over\"";
+                break;
+            case 1:
+                out.push_back('[');
+                for (int s = 0; s < numPlayers; ++s) {
+                    if (s > 0) out.push_back(',');
+                    out += '"';
+                    out += seatKindName(seats_[s]);
+                    out += '"';
+                }
+                out.push_back(']');
+                break;
+            case 2:
+                out += std::to_string(game_.getCurrentRound());
+                break;
+            case 3:
+                out += std::to_string(inPlay ? game_.getCurrentSeat() : -1);
+                break;
+            case 4:
+                out += std::to_string(inPlay ? game_.getDealsRemaining() : 0);
+                break;
+            case 5:
+                out += std::to_string(game_.getSupplySize());
+                break;
+            case 6: {
+                CardMask bazaar = 0;
+                for (const auto& card : game_.getBazaar()) bazaar |= card.getMask();
+                appendCards(out, bazaar);
+                break;
+            }
+            case 7:
+                appendCards(out, seat >= 0 ? players[seat].getHandMask() : 0);
+                break;
+            case 8:
+                out.push_back('[');
+                for (int s = 0; s < numPlayers; ++s) {
+                    if (s > 0) out.push_back(',');
+                    out += "{\"points\":" + std::to_string(players[s].getTotalPoints());
+                    out += ",\"hand\":" + std::to_string(players[s].getHandSize());
+                    out += ",\"contracts\":[";
+                    const auto& contracts = players[s].getContracts();
+                    for (size_t i = 0; i < contracts.size(); ++i) {
+                        if (i > 0) out.push_back(',');
+                        out += "{\"contract\":\"";
+                        out += kContractNames[static_cast<int>(contracts[i]->getType())];
+                        out += "\",\"cards\":";
+                        appendCards(out, contracts[i]->getCardMask());
+                        out.push_back('}');
+                    }
+                    out += "]}";
+                }
+                out.push_back(']');
+                break;
+            case 9:
+                out += std::to_string(game_.isFinished() ? game_.getWinner().getId() - 1 : -1);
+                break;
+        }
+
+        std::uint64_t hash = fnv1a(out.data() + fieldStart, out.size() - fieldStart);
+        if (hash == sent[field]) {
+            out.resize(fieldStart);
+        } else {
+            sent[field] = hash;
+            changed = true;
+        }
+    }
+
+    if (!changed) {
+        out.resize(messageStart);
+        return false;
+    }
+    out.push_back('}');
+    return true;
+}
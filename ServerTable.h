@@ -0,0 +1,58 @@
+#ifndef SERVER_TABLE_H
+#define SERVER_TABLE_H
+
+#include "Game.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+// One game hosted by the GameServer. Seats start open; players claim them by
+// joining, and once the table starts every seat still open is played by the
+// greedy AI. A player who leaves mid-game hands their seat to the AI too.
+// Humans choose their own deals. Their barter exchanges are made by the
+// default Strategy::chooseExchange, as the protocol has no barter step.
+//
+// Clients see the game as a handful of JSON fields. writeView() sends only
+// the fields whose text changed since the last view written with the same
+// ViewHashes, so a move usually costs a few hundred bytes per client.
+class ServerTable {
+public:
+    enum class SeatKind : std::uint8_t { OPEN, HUMAN, AI };
+
+    static constexpr int kViewFields = 10;
+    using ViewHashes = std::array<std::uint64_t, kViewFields>;
+
+    ServerTable(std::uint64_t id, int numPlayers, std::uint64_t seed);
+
+    std::uint64_t getId() const { return id_; }
+    bool isStarted() const { return started_; }
+    bool isFinished() const { return game_.isFinished(); }
+    int getHumanCount() const;
+
+    // Claims the first open seat, or returns -1 if there is none
+    int join();
+    void leave(int seat);
+    void start();
+
+    // Applies one JSON command from `seat` ({"op":"start"|"hold"|"sign"|"extend", ...}),
+    // then lets the AI play until a human must decide. Returns an error message,
+    // or an empty string if the command was applied.
+    std::string handleCommand(int seat, const char* json, size_t size);
+
+    // Appends a {"type":"state",...} message with the changed fields to `out`;
+    // `seat` -1 is a spectator, who sees no hand. Returns false, appending
+    // nothing, if no field changed.
+    bool writeView(int seat, ViewHashes& sent, std::string& out) const;
+
+private:
+    std::uint64_t id_;
+    Game game_;
+    std::array<SeatKind, GameState::kMaxPlayers> seats_;
+    bool started_;
+    bool turnOpen_;  // beginTurn() ran for the current seat and endTurn() has not
+
+    void advance();
+    void closeTurn();
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include "Statistics.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+void RunningStats::add(long long value) {
+    if (count_ == 0 || value < min_) min_ = value;
+    if (count_ == 0 || value > max_) max_ = value;
+    count_++;
+    sum_ += value;
+    squaredSum_ += value * value;
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count_ == 0) return;
+    if (count_ == 0 || other.min_ < min_) min_ = other.min_;
+    if (count_ == 0 || other.max_ > max_) max_ = other.max_;
+    count_ += other.count_;
+    sum_ += other.sum_;
+    squaredSum_ += other.squaredSum_;
+}
+
+double RunningStats::getMean() const {
+    return count_ ? static_cast<double>(sum_) / count_ : 0.0;
+}
+
+double RunningStats::getVariance() const {
+    if (count_ < 2) return 0.0;
+    double mean = static_cast<double>(sum_) / count_;
+    return (static_cast<double>(squaredSum_) - mean * sum_) / (count_ - 1);
+}
+
+Histogram::Histogram(int minValue, int maxValue)
+    : minValue_(minValue), count_(0), buckets_(maxValue - minValue + 1, 0) {
+    if (maxValue < minValue) {
+        throw std::invalid_argument("Histogram range is empty");
+    }
+}
+
+void Histogram::add(int value) {
+    int bucket = std::min(std::max(value - minValue_, 0), static_cast<int>(buckets_.size()) - 1);
+    buckets_[bucket]++;
+    count_++;
+}
+
+void Histogram::merge(const Histogram& other) {
+    if (other.minValue_ != minValue_ || other.buckets_.size() != buckets_.size()) {
+        throw std::invalid_argument("Histograms with different buckets cannot be merged");
+    }
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+}
+
+int Histogram::quantile(double q) const {
+    if (count_ == 0) return minValue_;
+    // Rank of the sample, 1-based; q = 0 gives the smallest sample
+    long long rank = std::max(1LL, static_cast<long long>(std::ceil(q * count_)));
+    long long seen = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) return minValue_ + static_cast<int>(i);
+    }
+    return minValue_ + static_cast<int>(buckets_.size()) - 1;
+}
+
+double confidenceHalfWidth(const RunningStats& stats, double scale) {
+    if (stats.getCount() < 2) return 0.0;
+    return 1.96 * std::sqrt(stats.getVariance() / stats.getCount()) / scale;
+}
+
+SprtDecision sprtTest(const RunningStats& samples, double scale, const StoppingRule& rule) {
+    if (rule.sprtEffect == 0.0 || samples.getCount() < std::max(2LL, rule.minSamples)) return SprtDecision::CONTINUE;
+    double effect = rule.sprtEffect * scale;
+    double variance = samples.getVariance();
+    if (variance <= 0.0) {
+        // Every sample the same: the mean is exact
+        bool nearerEffect = std::abs(samples.getMean() - effect) < std::abs(samples.getMean());
+        return nearerEffect ? SprtDecision::ACCEPT_EFFECT : SprtDecision::ACCEPT_NULL;
+    }
+
+    // Log likelihood ratio of N(effect, variance) over N(0, variance) for the samples seen
+    double n = static_cast<double>(samples.getCount());
+    double llr = effect * (samples.getMean() * n - n * effect / 2.0) / variance;
+    if (llr >= std::log((1.0 - rule.beta) / rule.alpha)) return SprtDecision::ACCEPT_EFFECT;
+    if (llr <= std::log(rule.beta / (1.0 - rule.alpha))) return SprtDecision::ACCEPT_NULL;
+    return SprtDecision::CONTINUE;
+}
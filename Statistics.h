@@ -0,0 +1,125 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <atomic>
+#include <climits>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Mergeable accumulators for batch statistics. A worker fills one set per
+// chunk of games, and a ChunkSequencer merges finished chunks in chunk order,
+// so nothing is shared while games run. Samples are integers and everything is
+// kept as exact integer counts, so merging in any order gives bit-identical
+// results.
+
+// Count, mean, variance and range of integer samples, from exact power sums
+class RunningStats {
+public:
+    void add(long long value);
+    void merge(const RunningStats& other);
+
+    long long getCount() const { return count_; }
+    long long getMin() const { return min_; }
+    long long getMax() const { return max_; }
+    double getMean() const;
+    double getVariance() const;  // Sample variance (n - 1)
+
+private:
+    long long count_ = 0;
+    long long sum_ = 0;
+    long long squaredSum_ = 0;
+    long long min_ = 0;
+    long long max_ = 0;
+};
+
+// One bucket per integer in [minValue, maxValue]; samples outside are counted
+// in the end buckets. Points and margins are small bounded integers, so unit
+// buckets give exact quantiles in constant memory, which is all a quantile
+// sketch could offer here.
+class Histogram {
+public:
+    Histogram(int minValue, int maxValue);
+
+    void add(int value);
+    void merge(const Histogram& other);
+
+    long long getCount() const { return count_; }
+    int getMinValue() const { return minValue_; }
+    const std::vector<long long>& getBuckets() const { return buckets_; }
+
+    // Smallest value with at least fraction `q` of the samples at or below it
+    int quantile(double q) const;
+
+private:
+    int minValue_;
+    long long count_;
+    std::vector<long long> buckets_;
+};
+
+// When a batch may end before its game count. Off by default; a batch with
+// a rule still never plays more games than it was given.
+struct StoppingRule {
+    double targetError = 0.0;   // Stop once the 95% CI half-width is at most this
+    double sprtEffect = 0.0;    // SPRT: no difference against a difference of this size
+    double alpha = 0.05;        // SPRT false positive rate
+    double beta = 0.05;         // SPRT false negative rate
+    long long minSamples = 256; // Fewer samples give too rough a variance to stop on
+
+    bool isActive() const { return targetError > 0.0 || sprtEffect != 0.0; }
+};
+
+// Half-width of a 95% normal confidence interval on the mean of `stats`, over `scale`
+double confidenceHalfWidth(const RunningStats& stats, double scale = 1.0);
+
+enum class SprtDecision { CONTINUE, ACCEPT_NULL, ACCEPT_EFFECT };
+
+// Gaussian sequential probability ratio test on the mean of `samples`, each
+// `scale` times the quantity tested: mean 0 against mean `rule.sprtEffect`,
+// with the variance estimated from the samples
+SprtDecision sprtTest(const RunningStats& samples, double scale, const StoppingRule& rule);
+
+// Folds per-chunk results in chunk order, whichever worker finishes them, and
+// asks `shouldStop` after every chunk. A stop therefore lands on the same game
+// for any thread count. Workers only take the lock to hand over a finished
+// chunk; the ones still playing are never waited on.
+template <typename Results>
+class ChunkSequencer {
+public:
+    ChunkSequencer(Results total, std::function<bool(const Results&)> shouldStop)
+        : total_(std::move(total)), shouldStop_(std::move(shouldStop)) {}
+
+    // Chunks at or past this are not needed
+    long long getLimit() const { return limit_.load(std::memory_order_relaxed); }
+    bool isStopped() const { return getLimit() != LLONG_MAX; }
+
+    void submit(long long chunk, Results&& results) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (chunk >= getLimit()) return;
+        pending_.emplace(chunk, std::move(results));
+        for (auto it = pending_.begin(); it != pending_.end() && it->first == folded_; it = pending_.erase(it)) {
+            total_.merge(it->second);
+            folded_++;
+            if (shouldStop_ && shouldStop_(total_)) {
+                limit_.store(folded_, std::memory_order_relaxed);
+                pending_.clear();
+                return;
+            }
+        }
+    }
+
+    // Call once every worker has finished
+    Results take() { return std::move(total_); }
+
+private:
+    std::mutex mutex_;
+    Results total_;
+    std::function<bool(const Results&)> shouldStop_;
+    std::map<long long, Results> pending_;
+    long long folded_ = 0;
+    std::atomic<long long> limit_{LLONG_MAX};
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "Strategy.h"
+#include "BarterEvaluator.h"
+#include "Game.h"
+
+DealDecision DealDecision::sign(ContractType type, CardMask cards) {
+    DealDecision decision;
+    decision.kind = Kind::SIGN;
+    decision.type = type;
+    decision.cards = cards;
+    return decision;
+}
+
+DealDecision DealDecision::sign(const Player::PossibleContract& contract) {
+    return sign(contract.type, contract.mask);
+}
+
+DealDecision DealDecision::extend(int contractIndex, const Card& card) {
+    DealDecision decision;
+    decision.kind = Kind::EXTEND;
+    decision.contractIndex = contractIndex;
+    decision.cardIndex = card.getIndex();
+    return decision;
+}
+
+ExchangeDecision Strategy::chooseExchange(const Game& game, const Player& player, const Contract& route) {
+    BarterEvaluator evaluator(player, game.getBazaar());
+    return evaluator.bestExchange(player.getHandMask(), route.getTradeCost());
+}
+
+DealDecision GreedyStrategy::chooseDeal(const Game&, const Player& player) {
+    const Player::PossibleContract* bestContract = player.selectBestContract();
+
+    if (!bestContract || bestContract->points == 0) {
+        return DealDecision::hold(); // No valid contracts to make
+    }
+
+    // Check if we should extend an existing contract instead
+    if (bestContract->mask & player.getExtensionCards()) {
+        const auto& contracts = player.getContracts();
+        for (size_t i = 0; i < contracts.size(); ++i) {
+            for (const auto& card : bestContract->cards) {
+                if (player.shouldExtendContract(*contracts[i], card)) {
+                    return DealDecision::extend(static_cast<int>(i), card);
+                }
+            }
+        }
+    }
+
+    return DealDecision::sign(*bestContract);
+}
+
+GreedyStrategy& GreedyStrategy::instance() {
+    static GreedyStrategy strategy;
+    return strategy;
+}
@@ -0,0 +1,57 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include "Player.h"
+
+class Game;
+
+// One step of a deal phase: sign a new contract, extend an existing one by a
+// single card, or hold and end the deal phase. A plain value, so deciding
+// never allocates.
+struct DealDecision {
+    enum class Kind { HOLD, SIGN, EXTEND };
+
+    Kind kind = Kind::HOLD;
+    ContractType type = ContractType::PARTNERSHIP;  // SIGN
+    CardMask cards = 0;                             // SIGN: cards of the new contract
+    int contractIndex = -1;                         // EXTEND: index into Player::getContracts()
+    int cardIndex = -1;                             // EXTEND: Card::getIndex() of the added card
+
+    static DealDecision hold() { return {}; }
+    static DealDecision sign(ContractType type, CardMask cards);
+    static DealDecision sign(const Player::PossibleContract& contract);
+    static DealDecision extend(int contractIndex, const Card& card);
+};
+
+// One bazaar exchange made with a trade-rights contract: give exactly the
+// contract's trade cost in cards and take one bazaar card, or pass
+struct ExchangeDecision {
+    bool trade = false;
+    CardMask give = 0;
+    int bazaarIndex = -1;
+
+    static ExchangeDecision pass() { return {}; }
+};
+
+class Strategy {
+public:
+    virtual ~Strategy() = default;
+
+    // Called once per deal while the player has deals left
+    virtual DealDecision chooseDeal(const Game& game, const Player& player) = 0;
+
+    // Called once per trade-rights contract in the barter phase. The default
+    // takes the exchange that most improves the hand (see BarterEvaluator).
+    virtual ExchangeDecision chooseExchange(const Game& game, const Player& player, const Contract& route);
+};
+
+// The original one-ply AI: sign the most efficient contract in hand, or use
+// one of its cards to extend an existing contract when that scores more
+class GreedyStrategy : public Strategy {
+public:
+    DealDecision chooseDeal(const Game& game, const Player& player) override;
+
+    static GreedyStrategy& instance();
+};
+
+#endif
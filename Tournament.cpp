@@ -0,0 +1,230 @@
+#include "Tournament.h"
+#include "Game.h"
+#include "GameLog.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Games handed to a worker at a time
+constexpr long long kChunkSize = 64;
+
+constexpr int kNumContractTypes = 4;
+
+}
+
+double TournamentResults::getWinRate(int seat) const {
+    if (gamesPlayed == 0 || seat < 0 || seat >= (int)winsBySeat.size()) return 0.0;
+    return static_cast<double>(winsBySeat[seat]) / gamesPlayed;
+}
+
+double TournamentResults::getWinRateError(int seat) const {
+    if (gamesPlayed == 0) return 0.0;
+    double rate = getWinRate(seat);
+    return 1.96 * std::sqrt(rate * (1.0 - rate) / gamesPlayed);
+}
+
+long long TournamentResults::getContractCount(ContractType type) const {
+    long long count = 0;
+    for (long long bySize : contractsBySize[static_cast<int>(type)]) count += bySize;
+    return count;
+}
+
+bool TournamentResults::meetsTargetError(const StoppingRule& rule) const {
+    if (rule.targetError <= 0.0 || gamesPlayed < rule.minSamples) return false;
+    for (size_t seat = 0; seat < winsBySeat.size(); ++seat) {
+        if (getWinRateError(static_cast<int>(seat)) > rule.targetError) return false;
+    }
+    return true;
+}
+
+void TournamentResults::merge(const TournamentResults& other) {
+    gamesPlayed += other.gamesPlayed;
+    if (winsBySeat.size() < other.winsBySeat.size()) {
+        winsBySeat.resize(other.winsBySeat.size(), 0);
+    }
+    for (size_t i = 0; i < other.winsBySeat.size(); ++i) {
+        winsBySeat[i] += other.winsBySeat[i];
+    }
+    points.merge(other.points);
+    rounds.merge(other.rounds);
+    pointsHistogram.merge(other.pointsHistogram);
+    winningMargin.merge(other.winningMargin);
+    for (int type = 0; type < kNumContractTypes; ++type) {
+        for (size_t i = 0; i < contractsBySize[type].size(); ++i) {
+            contractsBySize[type][i] += other.contractsBySize[type][i];
+        }
+        for (size_t i = 0; i < contractsByRound[type].size(); ++i) {
+            contractsByRound[type][i] += other.contractsByRound[type][i];
+        }
+    }
+    guildStanding.merge(other.guildStanding);
+    caravanCapacity.merge(other.caravanCapacity);
+    marketShare.merge(other.marketShare);
+    silkRoadMarks.merge(other.silkRoadMarks);
+}
+
+std::string TournamentResults::toString() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(4);
+    oss << "=== TOURNAMENT RESULTS ===\n";
+    oss << "Games played: " << gamesPlayed << (stoppedEarly ? " (stopping rule met)" : "") << "\n";
+    oss << "\nWin rate by seat (95% CI):\n";
+    for (size_t i = 0; i < winsBySeat.size(); ++i) {
+        oss << "  Player " << (i + 1) << ": " << getWinRate(i) << " +/- " << getWinRateError(i)
+            << " (" << winsBySeat[i] << " wins)\n";
+    }
+    oss << "\nPoints per player: mean " << getMeanPoints()
+        << ", variance " << getPointsVariance() << "\n";
+    oss << "  Quantiles: 10% " << pointsHistogram.quantile(0.1) << ", 25% " << pointsHistogram.quantile(0.25)
+        << ", median " << pointsHistogram.quantile(0.5) << ", 75% " << pointsHistogram.quantile(0.75)
+        << ", 90% " << pointsHistogram.quantile(0.9) << ", max " << points.getMax() << "\n";
+    oss << "Winning margin: median " << winningMargin.quantile(0.5) << ", 90% " << winningMargin.quantile(0.9)
+        << ", 99% " << winningMargin.quantile(0.99) << "\n";
+    oss << "Rounds per game: mean " << getMeanRounds()
+        << ", variance " << getRoundsVariance() << "\n";
+
+    long long totalContracts = 0;
+    for (int type = 0; type < kNumContractTypes; ++type) {
+        totalContracts += getContractCount(static_cast<ContractType>(type));
+    }
+    oss << "\nContract frequencies:\n";
+    for (int type = 0; type < kNumContractTypes; ++type) {
+        long long count = getContractCount(static_cast<ContractType>(type));
+        double share = totalContracts ? static_cast<double>(count) / totalContracts : 0.0;
+        oss << "  " << contractTypeToString(static_cast<ContractType>(type)) << ": "
+            << count << " (" << share << ")\n";
+    }
+
+    oss << "\nContracts by size (3-" << kMaxContractSize << " cards) and mean round signed:\n";
+    for (int type = 0; type < kNumContractTypes; ++type) {
+        oss << "  " << std::left << std::setw(12) << contractTypeToString(static_cast<ContractType>(type)) << std::right;
+        for (int size = 3; size <= kMaxContractSize; ++size) {
+            oss << std::setw(10) << contractsBySize[type][size];
+        }
+        long long count = 0, roundSum = 0;
+        for (int round = 0; round < kMaxTrackedRounds; ++round) {
+            count += contractsByRound[type][round];
+            roundSum += contractsByRound[type][round] * round;
+        }
+        oss << "   round " << (count ? static_cast<double>(roundSum) / count : 0.0) << "\n";
+    }
+
+    oss << "\nVotes per player: guild standing " << guildStanding.getMean()
+        << ", caravan capacity " << caravanCapacity.getMean()
+        << ", market share " << marketShare.getMean()
+        << ", Silk Road marks " << silkRoadMarks.getMean() << "\n";
+    return oss.str();
+}
+
+Tournament::Tournament(const TournamentConfig& config) : config_(config) {
+    if (config.stopping.sprtEffect != 0.0) {
+        throw std::invalid_argument("A batch stops on targetError only; the SPRT needs duplicate deals");
+    }
+}
+
+void Tournament::playGame(long long index, Game& game, TournamentResults& results) const {
+    game.reset(config_.masterSeed, static_cast<std::uint64_t>(index));
+    game.play();
+
+    const auto& players = game.getPlayers();
+    const Player& winner = game.getWinner();
+
+    results.gamesPlayed++;
+    results.rounds.add(game.getCurrentRound());
+
+    int bestOther = 0;
+    for (size_t seat = 0; seat < players.size(); ++seat) {
+        const auto& player = players[seat];
+        if (&player == &winner) {
+            results.winsBySeat[seat]++;
+        } else {
+            bestOther = std::max(bestOther, player.getTotalPoints());
+        }
+
+        int points = player.getTotalPoints();
+        results.points.add(points);
+        results.pointsHistogram.add(points);
+
+        for (const auto& contract : player.getContracts()) {
+            int type = static_cast<int>(contract->getType());
+            results.contractsBySize[type][std::min(contract->getSize(), TournamentResults::kMaxContractSize)]++;
+            results.contractsByRound[type][std::min(contract->getRoundCreated(), TournamentResults::kMaxTrackedRounds - 1)]++;
+        }
+
+        const auto& votes = player.getVoteBreakdown();
+        int guildStanding = 0;
+        for (int standing : votes.guildStanding) guildStanding += standing;
+        results.guildStanding.add(guildStanding);
+        results.caravanCapacity.add(votes.caravanCapacity);
+        results.marketShare.add(votes.marketShare);
+        results.silkRoadMarks.add(votes.silkRoadMarks);
+    }
+    results.winningMargin.add(winner.getTotalPoints() - bestOther);
+}
+
+TournamentResults Tournament::run() const {
+    int numThreads = config_.numThreads;
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    TournamentResults empty;
+    empty.winsBySeat.assign(config_.numPlayers, 0);
+
+    const StoppingRule& rule = config_.stopping;
+    std::function<bool(const TournamentResults&)> shouldStop;
+    if (rule.targetError > 0.0) {
+        shouldStop = [&](const TournamentResults& results) { return results.meetsTargetError(rule); };
+    }
+    ChunkSequencer<TournamentResults> sequencer(empty, shouldStop);
+    std::atomic<long long> nextChunk(0);
+
+    auto worker = [&]() {
+        Game game(config_.numPlayers, config_.masterSeed);
+        std::vector<std::unique_ptr<Strategy>> strategies(config_.numPlayers);
+        if (config_.strategyFactory) {
+            for (int seat = 0; seat < config_.numPlayers; ++seat) {
+                strategies[seat] = config_.strategyFactory(seat);
+                game.setStrategy(seat, strategies[seat].get());
+            }
+        }
+        std::unique_ptr<GameLogSink> logSink;
+        if (config_.log) {
+            logSink = std::make_unique<GameLogSink>(*config_.log);
+            game.setEventSink(logSink.get());
+        }
+
+        for (;;) {
+            long long chunk = nextChunk.fetch_add(1);
+            long long begin = chunk * kChunkSize;
+            if (begin >= config_.numGames || chunk >= sequencer.getLimit()) break;
+            long long end = std::min(begin + kChunkSize, config_.numGames);
+            TournamentResults local = empty;
+            for (long long index = begin; index < end; ++index) {
+                playGame(index, game, local);
+            }
+            sequencer.submit(chunk, std::move(local));
+        }
+
+        logSink.reset(); // Hands its last games to the writer
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    TournamentResults total = sequencer.take();
+    total.stoppedEarly = sequencer.isStopped();
+    return total;
+}
@@ -0,0 +1,91 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include "Contract.h"
+#include "Statistics.h"
+#include "Strategy.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Game;
+class GameLogWriter;
+
+struct TournamentConfig {
+    long long numGames = 1000;
+    int numPlayers = 4;
+    int numThreads = 0;          // 0 = one per hardware thread
+    std::uint64_t masterSeed = 1;
+
+    // Called once per worker thread and seat; returning nullptr keeps the greedy AI
+    std::function<std::unique_ptr<Strategy>(int seat)> strategyFactory;
+
+    // When set, every game is recorded; games appear in the log in completion order
+    GameLogWriter* log = nullptr;
+
+    // targetError bounds every seat's win rate; numGames becomes a cap. A batch
+    // has no paired difference to test, so sprtEffect is rejected.
+    StoppingRule stopping;
+};
+
+// Summaries of finished games, one per chunk of games, merged in chunk order.
+// Memory is fixed however many games are played; nothing of a game outlives it.
+struct TournamentResults {
+    static constexpr int kMaxTrackedPoints = 127;  // Larger scores and margins share the top bucket
+    static constexpr int kMaxContractSize = 7;
+    static constexpr int kMaxTrackedRounds = 32;   // Later rounds share the last bucket
+
+    long long gamesPlayed = 0;
+    bool stoppedEarly = false;
+    std::vector<long long> winsBySeat;
+
+    // Final standings, as printResults ranks them
+    RunningStats points;                           // One sample per player per game
+    RunningStats rounds;
+    Histogram pointsHistogram{0, kMaxTrackedPoints};
+    Histogram winningMargin{0, kMaxTrackedPoints};  // Winner over the best other player
+
+    // Contracts held at the end of each game
+    std::array<std::array<long long, kMaxContractSize + 1>, 4> contractsBySize{};
+    std::array<std::array<long long, kMaxTrackedRounds>, 4> contractsByRound{};  // Round signed
+
+    // Final vote breakdown, one sample per player per game
+    RunningStats guildStanding;                    // Summed over suits
+    RunningStats caravanCapacity;
+    RunningStats marketShare;
+    RunningStats silkRoadMarks;
+
+    double getWinRate(int seat) const;
+    double getWinRateError(int seat) const;  // 95% CI half-width
+    double getMeanPoints() const { return points.getMean(); }
+    double getPointsVariance() const { return points.getVariance(); }
+    double getMeanRounds() const { return rounds.getMean(); }
+    double getRoundsVariance() const { return rounds.getVariance(); }
+    long long getContractCount(ContractType type) const;
+
+    // Whether every seat's win rate is within the rule's target error
+    bool meetsTargetError(const StoppingRule& rule) const;
+
+    void merge(const TournamentResults& other);
+    std::string toString() const;
+};
+
+class Tournament {
+public:
+    explicit Tournament(const TournamentConfig& config);
+
+    // Game `index` is dealt from (masterSeed, index), never from scheduling, so
+    // any one game can be replayed alone with Game(numPlayers, masterSeed, index)
+    TournamentResults run() const;
+
+private:
+    TournamentConfig config_;
+
+    // Replays `game` in place as game `index`, so a worker allocates nothing per game
+    void playGame(long long index, Game& game, TournamentResults& results) const;
+};
+
+#endif
@@ -0,0 +1,27 @@
+#include "TranspositionTable.h"
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+int checkedBits(int bits) {
+    if (bits < TranspositionTable::kMinBits || bits > TranspositionTable::kMaxBits) {
+        throw std::invalid_argument("Transposition table bits must be " + std::to_string(TranspositionTable::kMinBits)
+                                    + "-" + std::to_string(TranspositionTable::kMaxBits));
+    }
+    return bits;
+}
+
+}
+
+TranspositionTable::TranspositionTable(int bits)
+    : slots_(new Slot[std::size_t(1) << checkedBits(bits)]), shift_(64 - bits) {
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < getCapacity(); ++i) {
+        slots_[i].check.store(emptyKey(i), std::memory_order_relaxed);
+        slots_[i].data.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed-size map from 64-bit position keys (Game::getHash(), or any other key)
+// to one 64-bit entry, safe to share between any number of search threads
+// without locks. Each slot is always replaced on store. Slots are Hyatt-style
+// lockless: the check word holds key ^ data, so a read that races a write sees
+// a mismatched pair and counts as a miss instead of returning a torn entry.
+//
+// An empty slot holds a key that hashes to a different slot, so no key, 0
+// included, can ever read it as present.
+class TranspositionTable {
+public:
+    static constexpr int kMinBits = 1;
+    static constexpr int kMaxBits = 40;
+
+    // 2^bits slots; throws std::invalid_argument outside [kMinBits, kMaxBits]
+    explicit TranspositionTable(int bits = 20);
+
+    bool probe(std::uint64_t key, std::uint64_t& data) const {
+        const Slot& slot = slotFor(key);
+        std::uint64_t stored = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ stored) != key) return false;
+        data = stored;
+        return true;
+    }
+
+    void store(std::uint64_t key, std::uint64_t data) {
+        Slot& slot = slotFor(key);
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+    // Not safe while other threads are probing or storing
+    void clear();
+
+    std::size_t getCapacity() const { return std::size_t(1) << (64 - shift_); }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    int shift_;
+
+    // Fibonacci hashing, so structured keys (hand masks) spread as well as random ones
+    std::size_t indexFor(std::uint64_t key) const {
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    Slot& slotFor(std::uint64_t key) const {
+        return slots_[indexFor(key)];
+    }
+
+    // ~0 hashes to one slot and 1 to another for every size (the multiplier's
+    // top bit is set, its negation's is clear), so each empty slot gets whichever
+    // of the two lands elsewhere
+    std::uint64_t emptyKey(std::size_t index) const {
+        return index == indexFor(~std::uint64_t(0)) ? 1 : ~std::uint64_t(0);
+    }
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "WebSocket.h"
+#include <array>
+
+namespace {
+
+const char kHandshakeGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+std::uint32_t rotateLeft(std::uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// SHA-1 is only used for the handshake, where the RFC requires it
+std::array<std::uint8_t, 20> sha1(const std::string& message) {
+    std::uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    std::string padded = message;
+    padded.push_back(static_cast<char>(0x80));
+    while (padded.size() % 64 != 56) padded.push_back('\0');
+    std::uint64_t bits = std::uint64_t(message.size()) * 8;
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        padded.push_back(static_cast<char>((bits >> shift) & 0xFF));
+    }
+
+    for (size_t block = 0; block < padded.size(); block += 64) {
+        std::uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            const auto* p = reinterpret_cast<const std::uint8_t*>(padded.data() + block + i * 4);
+            w[i] = (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | p[3];
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        std::uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            std::uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            std::uint32_t temp = rotateLeft(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotateLeft(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    std::array<std::uint8_t, 20> digest;
+    for (int i = 0; i < 5; ++i) {
+        digest[i * 4] = static_cast<std::uint8_t>(h[i] >> 24);
+        digest[i * 4 + 1] = static_cast<std::uint8_t>(h[i] >> 16);
+        digest[i * 4 + 2] = static_cast<std::uint8_t>(h[i] >> 8);
+        digest[i * 4 + 3] = static_cast<std::uint8_t>(h[i]);
+    }
+    return digest;
+}
+
+std::string base64(const std::uint8_t* data, size_t size) {
+    static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < size; i += 3) {
+        std::uint32_t chunk = std::uint32_t(data[i]) << 16;
+        if (i + 1 < size) chunk |= std::uint32_t(data[i + 1]) << 8;
+        if (i + 2 < size) chunk |= data[i + 2];
+        out.push_back(kAlphabet[(chunk >> 18) & 63]);
+        out.push_back(kAlphabet[(chunk >> 12) & 63]);
+        out.push_back(i + 1 < size ? kAlphabet[(chunk >> 6) & 63] : '=');
+        out.push_back(i + 2 < size ? kAlphabet[chunk & 63] : '=');
+    }
+    return out;
+}
+
+}
+
+std::string webSocketAcceptKey(const std::string& clientKey) {
+    auto digest = sha1(clientKey + kHandshakeGuid);
+    return base64(digest.data(), digest.size());
+}
+
+FrameStatus decodeWebSocketFrame(char* data, size_t size, size_t maxPayload, WebSocketFrame& frame) {
+    if (size < 2) return FrameStatus::INCOMPLETE;
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(data);
+
+    frame.final = (bytes[0] & 0x80) != 0;
+    frame.opcode = static_cast<WebSocketOpcode>(bytes[0] & 0x0F);
+    if (bytes[0] & 0x70) return FrameStatus::INVALID;  // No extensions were negotiated
+    if (!(bytes[1] & 0x80)) return FrameStatus::INVALID;  // Clients must mask
+
+    size_t header = 2;
+    std::uint64_t length = bytes[1] & 0x7F;
+    if (length == 126) {
+        if (size < 4) return FrameStatus::INCOMPLETE;
+        length = (std::uint64_t(bytes[2]) << 8) | bytes[3];
+        header = 4;
+    } else if (length == 127) {
+        if (size < 10) return FrameStatus::INCOMPLETE;
+        length = 0;
+        for (int i = 2; i < 10; ++i) length = (length << 8) | bytes[i];
+        header = 10;
+    }
+    if (length > maxPayload) return FrameStatus::INVALID;
+    if (size < header + 4 + length) return FrameStatus::INCOMPLETE;
+
+    const std::uint8_t* mask = bytes + header;
+    char* payload = data + header + 4;
+    for (std::uint64_t i = 0; i < length; ++i) {
+        payload[i] = static_cast<char>(payload[i] ^ mask[i % 4]);
+    }
+    frame.payloadOffset = header + 4;
+    frame.payloadSize = static_cast<size_t>(length);
+    frame.frameSize = frame.payloadOffset + frame.payloadSize;
+    return FrameStatus::COMPLETE;
+}
+
+void appendWebSocketFrame(std::string& out, WebSocketOpcode opcode, const char* payload, size_t size) {
+    out.push_back(static_cast<char>(0x80 | static_cast<std::uint8_t>(opcode)));
+    if (size < 126) {
+        out.push_back(static_cast<char>(size));
+    } else if (size <= 0xFFFF) {
+        out.push_back(static_cast<char>(126));
+        out.push_back(static_cast<char>((size >> 8) & 0xFF));
+        out.push_back(static_cast<char>(size & 0xFF));
+    } else {
+        out.push_back(static_cast<char>(127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>((std::uint64_t(size) >> shift) & 0xFF));
+        }
+    }
+    out.append(payload, size);
+}
@@ -0,0 +1,42 @@
+#ifndef WEB_SOCKET_H
+#define WEB_SOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// The parts of RFC 6455 the game server needs: the opening handshake key and
+// single-frame messages. Client frames arrive masked; server frames are sent
+// unmasked.
+enum class WebSocketOpcode : std::uint8_t {
+    CONTINUATION = 0x0,
+    TEXT = 0x1,
+    BINARY = 0x2,
+    CLOSE = 0x8,
+    PING = 0x9,
+    PONG = 0xA
+};
+
+struct WebSocketFrame {
+    WebSocketOpcode opcode = WebSocketOpcode::TEXT;
+    bool final = true;
+    size_t frameSize = 0;      // Header plus payload, i.e. bytes to consume
+    size_t payloadOffset = 0;  // Where the unmasked payload starts in the buffer
+    size_t payloadSize = 0;
+};
+
+enum class FrameStatus {
+    COMPLETE,    // `frame` describes a whole frame at the front of the buffer
+    INCOMPLETE,  // Wait for more bytes
+    INVALID      // Unmasked, oversized or malformed; drop the connection
+};
+
+// Sec-WebSocket-Accept for a client's Sec-WebSocket-Key
+std::string webSocketAcceptKey(const std::string& clientKey);
+
+// Parses the frame at the front of `data` and unmasks its payload in place
+FrameStatus decodeWebSocketFrame(char* data, size_t size, size_t maxPayload, WebSocketFrame& frame);
+
+void appendWebSocketFrame(std::string& out, WebSocketOpcode opcode, const char* payload, size_t size);
+
+#endif
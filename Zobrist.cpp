@@ -0,0 +1,28 @@
+#include "Zobrist.h"
+
+namespace {
+
+// Fixed seed: hashes must agree between runs, threads and saved logs
+ZobristKeys makeKeys() {
+    ZobristKeys keys;
+    Rng rng(0x5A0B7157ULL);
+    for (auto& position : keys.supply) {
+        for (auto& key : position) key = rng();
+    }
+    for (auto& key : keys.bazaar) key = rng();
+    for (auto& seat : keys.hand) {
+        for (auto& key : seat) key = rng();
+    }
+    for (auto& key : keys.contractCard) key = rng();
+    for (auto& key : keys.contractType) key = rng();
+    for (auto& seat : keys.contractSlot) {
+        for (auto& key : seat) key = rng();
+    }
+    for (auto& key : keys.seat) key = rng();
+    for (auto& key : keys.phase) key = rng();
+    return keys;
+}
+
+}
+
+const ZobristKeys kZobrist = makeKeys();
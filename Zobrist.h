@@ -0,0 +1,33 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Card.h"
+#include "GameState.h"
+#include <cstdint>
+
+// Random keys for every place a card can be. A position hashes to the XOR of
+// the keys of where its cards are, so moving one card is two XORs. Game keeps
+// the supply and bazaar part, Player its hand and Contract its own cards;
+// Game::getHash() combines them.
+struct ZobristKeys {
+    static constexpr int kNumContractTypes = 4;
+
+    std::uint64_t supply[kDeckSize][kDeckSize];  // [position][card]; draws come off the end
+    std::uint64_t bazaar[kDeckSize];             // A set: barter picks by card, never by slot
+    std::uint64_t hand[GameState::kMaxPlayers][kDeckSize];
+    std::uint64_t contractCard[kDeckSize];       // Owner-free; see contractSlot
+    std::uint64_t contractType[kNumContractTypes];
+    std::uint64_t contractSlot[GameState::kMaxPlayers][GameState::kMaxContracts];  // Mixed into each contract's hash
+    std::uint64_t seat[GameState::kMaxPlayers];
+    std::uint64_t phase[3];                      // GamePhase
+};
+
+extern const ZobristKeys kZobrist;
+
+// Contract hashes only say which cards and type a contract has; this places one
+// at `slot` in `seat`'s list. Not linear, so swapped contracts hash differently.
+inline std::uint64_t zobristPlaceContract(std::uint64_t contractHash, int seat, int slot) {
+    return splitMix64(contractHash ^ kZobrist.contractSlot[seat][slot]);
+}
+
+#endif
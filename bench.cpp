@@ -0,0 +1,395 @@
+#include "EndgameSolver.h"
+#include "Game.h"
+#include "LockstepEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// Every operator new in the process is counted, so a benchmark can report
+// allocations per operation alongside its time
+namespace {
+long long g_allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr std::uint64_t kCorpusSeed = 20240601;
+constexpr int kHandsPerSize = 256;
+constexpr int kMinHandSize = 3;
+constexpr int kMaxHandSize = 20;
+
+struct Options {
+    std::string filter;
+    double minTimeMs = 250.0;
+};
+
+// Keeps results alive so the optimizer cannot drop the measured work
+volatile long long g_sink = 0;
+
+// Runs `body` (which performs `opsPerCall` operations) until `minTimeMs` has passed
+template <typename Body>
+void measure(const Options& options, const std::string& name, long long opsPerCall, Body body) {
+    if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+
+    g_sink = g_sink + body(); // Warm caches and any lazily sized buffers
+
+    using Clock = std::chrono::steady_clock;
+    long long calls = 0;
+    long long allocationsBefore = g_allocations;
+    auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed{0};
+    do {
+        g_sink = g_sink + body();
+        ++calls;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < options.minTimeMs);
+
+    double ops = static_cast<double>(calls) * opsPerCall;
+    double nsPerOp = elapsed.count() * 1e6 / ops;
+    double allocationsPerOp = (g_allocations - allocationsBefore) / ops;
+    std::printf("%-44s %12.1f %14.0f %10.2f\n", name.c_str(), nsPerOp, 1e9 / nsPerOp, allocationsPerOp);
+}
+
+// Reproducible random hands: corpus[size] holds kHandsPerSize hands of that many cards
+std::vector<std::vector<CardMask>> makeHandCorpus() {
+    std::mt19937_64 rng(kCorpusSeed);
+    std::vector<std::vector<CardMask>> corpus(kMaxHandSize + 1);
+    int deck[kDeckSize];
+    for (int size = kMinHandSize; size <= kMaxHandSize; ++size) {
+        for (int i = 0; i < kHandsPerSize; ++i) {
+            for (int card = 0; card < kDeckSize; ++card) deck[card] = card;
+            std::shuffle(deck, deck + kDeckSize, rng);
+            CardMask hand = 0;
+            for (int card = 0; card < size; ++card) hand |= CardMask(1) << deck[card];
+            corpus[size].push_back(hand);
+        }
+    }
+    return corpus;
+}
+
+std::vector<Player> makePlayers(const std::vector<CardMask>& hands) {
+    std::vector<Player> players;
+    players.reserve(hands.size());
+    for (CardMask hand : hands) {
+        players.emplace_back(1);
+        players.back().setHand(hand);
+    }
+    return players;
+}
+
+// Signs the best candidate of each 20-card hand until none is left, so
+// every player ends up holding a realistic spread of contracts
+std::vector<Player> makePlayersWithContracts(const std::vector<CardMask>& hands, std::vector<Contract>& storage) {
+    storage.reserve(hands.size() * kMaxContractsPerGame);
+    std::vector<Player> players;
+    players.reserve(hands.size());
+    for (CardMask hand : hands) {
+        players.emplace_back(1);
+        Player& player = players.back();
+        player.setHand(hand);
+        while (const Player::PossibleContract* best = player.selectBestContract()) {
+            DealDecision sign = DealDecision::sign(*best);
+            storage.emplace_back(sign.type, sign.cards, 1);
+            player.addContract(storage.back());
+            player.removeCards(sign.cards);
+        }
+    }
+    return players;
+}
+
+void benchValidation(const Options& options, const std::vector<std::vector<CardMask>>& corpus) {
+    // Half the sets are real candidates, so both outcomes are exercised
+    std::vector<std::pair<ContractType, CardMask>> sets;
+    for (CardMask hand : corpus[12]) {
+        Player player(1);
+        player.setHand(hand);
+        for (const auto& candidate : player.findPossibleContracts()) {
+            DealDecision sign = DealDecision::sign(candidate);
+            sets.push_back({sign.type, sign.cards});
+        }
+    }
+    size_t valid = sets.size();
+    for (size_t i = 0; i < valid; ++i) {
+        CardMask cards = sets[i].second;
+        sets.push_back({sets[i].first, (cards & (cards - 1)) | corpus[3][i % kHandsPerSize]});
+    }
+
+    std::vector<std::vector<Card>> cardLists;
+    for (const auto& set : sets) cardLists.push_back(cardsFromMask(set.second));
+
+    measure(options, "Contract::isValidContract(mask)", static_cast<long long>(sets.size()), [&]() {
+        long long count = 0;
+        for (const auto& set : sets) count += Contract::isValidContract(set.first, set.second);
+        return count;
+    });
+    measure(options, "Contract::isValidContract(cards)", static_cast<long long>(sets.size()), [&]() {
+        long long count = 0;
+        for (size_t i = 0; i < sets.size(); ++i) count += Contract::isValidContract(sets[i].first, cardLists[i]);
+        return count;
+    });
+}
+
+// setHand() invalidates every lane, so each call rescans the hand per lane
+void benchFinders(const Options& options, const std::vector<std::vector<CardMask>>& corpus) {
+    const int handSize = 10;
+    std::vector<Player> players = makePlayers(corpus[handSize]);
+    long long ops = static_cast<long long>(players.size());
+    std::string suffix = " (" + std::to_string(handSize) + " cards)";
+
+    measure(options, "Player::selectBestContract" + suffix, ops, [&]() {
+        long long count = 0;
+        for (auto& player : players) {
+            player.setHand(player.getHandMask());
+            count += player.selectBestContract() != nullptr;
+        }
+        return count;
+    });
+    measure(options, "Player::findContractShapes" + suffix, ops, [&]() {
+        long long count = 0;
+        for (auto& player : players) {
+            player.setHand(player.getHandMask());
+            count += static_cast<long long>(player.findContractShapes().size());
+        }
+        return count;
+    });
+}
+
+void benchPossibleContracts(const Options& options, const std::vector<std::vector<CardMask>>& corpus) {
+    for (int size = kMinHandSize; size <= kMaxHandSize; ++size) {
+        std::vector<Player> players = makePlayers(corpus[size]);
+        long long ops = static_cast<long long>(players.size());
+
+        // setHand() invalidates every lane, so each call is a full rescan
+        measure(options, "Player::findPossibleContracts (" + std::to_string(size) + " cards)", ops, [&]() {
+            long long count = 0;
+            for (auto& player : players) {
+                player.setHand(player.getHandMask());
+                count += static_cast<long long>(player.findPossibleContracts().size());
+            }
+            return count;
+        });
+    }
+    
+    // A card leaves the hand and comes back, so only the lanes it touches are rescanned
+    const int handSize = 10;
+    std::vector<Player> players = makePlayers(corpus[handSize]);
+    long long ops = static_cast<long long>(players.size());
+    auto touchOneCard = [](Player& player) {
+        Card card = Card::fromIndex(lowestBitIndex(player.getHandMask()));
+        player.removeCard(card);
+        player.addCard(card);
+    };
+    std::string suffix = " (1 of " + std::to_string(handSize) + " moved)";
+    measure(options, "Player::findPossibleContracts" + suffix, ops, [&]() {
+        long long count = 0;
+        for (auto& player : players) {
+            touchOneCard(player);
+            count += static_cast<long long>(player.findPossibleContracts().size());
+        }
+        return count;
+    });
+    measure(options, "Player::findContractShapes" + suffix, ops, [&]() {
+        long long count = 0;
+        for (auto& player : players) {
+            touchOneCard(player);
+            count += static_cast<long long>(player.findContractShapes().size());
+        }
+        return count;
+    });
+}
+
+void benchExtension(const Options& options, const std::vector<std::vector<CardMask>>& corpus) {
+    std::vector<Contract> storage;
+    std::vector<Player> owners = makePlayersWithContracts(corpus[kMaxHandSize], storage);
+    std::vector<Player> players = makePlayers(corpus[10]);
+
+    long long checks = 0;
+    for (size_t i = 0; i < players.size(); ++i) {
+        checks += static_cast<long long>(owners[i].getContracts().size()) * players[i].getHandSize();
+    }
+
+    measure(options, "Player::shouldExtendContract", checks, [&]() {
+        long long count = 0;
+        for (size_t i = 0; i < players.size(); ++i) {
+            for (const Contract* contract : owners[i].getContracts()) {
+                for (CardMask hand = players[i].getHandMask(); hand; hand &= hand - 1) {
+                    count += players[i].shouldExtendContract(*contract, Card::fromIndex(lowestBitIndex(hand)));
+                }
+            }
+        }
+        return count;
+    });
+}
+
+// Rebuilds each player's score ledger from its contracts, as Game::restore does
+void benchScoreLedger(const Options& options, const std::vector<std::vector<CardMask>>& corpus) {
+    std::vector<Contract> storage;
+    std::vector<Player> players = makePlayersWithContracts(corpus[kMaxHandSize], storage);
+    std::vector<std::vector<Contract*>> contracts;
+    for (const auto& player : players) contracts.push_back(player.getContracts());
+
+    measure(options, "Player::addContract (ledger rebuild)", static_cast<long long>(players.size()), [&]() {
+        long long count = 0;
+        for (size_t i = 0; i < players.size(); ++i) {
+            players[i].clearContracts();
+            for (Contract* contract : contracts[i]) players[i].addContract(*contract);
+            count += players[i].getVoteBreakdown().caravanCapacity;
+        }
+        return count;
+    });
+}
+
+void benchHandShapes(const Options& options, const std::vector<std::vector<CardMask>>& corpus) {
+    const std::vector<CardMask>& hands = corpus[10];
+    std::vector<HandShapes> shapes(hands.size());
+
+    measure(options, "findHandShapes (10 cards)", static_cast<long long>(hands.size()), [&]() {
+        findHandShapes(hands.data(), static_cast<int>(hands.size()), shapes.data());
+        long long count = 0;
+        for (const auto& shape : shapes) count += shape.tradeRoute;
+        return count;
+    });
+}
+
+void benchGames(const Options& options) {
+    const int gamesPerCall = 64;
+    Game game(4, 1);
+    unsigned int seed = 1;
+
+    measure(options, "Game::play (4 players)", gamesPerCall, [&]() {
+        long long rounds = 0;
+        for (int i = 0; i < gamesPerCall; ++i) {
+            game.reset(seed++);
+            game.play();
+            rounds += game.getCurrentRound();
+        }
+        return rounds;
+    });
+
+    TournamentConfig config;
+    config.numGames = LockstepEngine::kLanes;
+    config.numThreads = 1;
+    measure(options, "LockstepEngine::run (4 players)", config.numGames, [&]() {
+        config.masterSeed++;
+        return LockstepEngine(config).run().rounds.getCount();
+    });
+}
+
+// Solves from cold: the table is cleared before every call, so nothing carries over
+void benchEndgame(const Options& options) {
+    const int positions = 32;
+    EndgameConfig config;
+    config.maxSupply = 4;
+    config.tableBits = 16;
+    EndgameSolver solver(config);
+
+    // Greedy games stopped at the first deal phase with four or fewer supply cards left
+    std::vector<GameState> starts;
+    for (int i = 0; starts.size() < (size_t)positions; ++i) {
+        Game game(4, kCorpusSeed, i);
+        while (!game.isFinished()) {
+            game.beginTurn();
+            if (solver.inRange(game) && game.getDealsRemaining() > 0) {
+                starts.push_back(game.snapshot());
+                break;
+            }
+            const Player& player = game.getPlayers()[game.getCurrentSeat()];
+            while (game.getDealsRemaining() > 0) {
+                DealDecision decision = GreedyStrategy::instance().chooseDeal(game, player);
+                if (decision.kind == DealDecision::Kind::HOLD) break;
+                game.applyDeal(decision);
+            }
+            game.endTurn();
+        }
+    }
+
+    Game game(starts[0]);
+    measure(options, "EndgameSolver::solve (supply <= 4)", positions, [&]() {
+        long long nodes = 0;
+        for (const auto& start : starts) {
+            solver.clear();
+            game.restore(start);
+            nodes += solver.solve(game).nodes;
+        }
+        return nodes;
+    });
+}
+
+// Once a Game has played one game, reset() + play() must not touch the heap.
+// The warm-up is kept short so buffers that only grow on demand cannot pass by
+// having seen enough hands. Returns false, after saying so, if any of `games`
+// further games allocates.
+bool checkSteadyStateAllocations(int games) {
+    Game game(4, 1);
+    unsigned int seed = 1;
+    game.reset(seed++);
+    game.play();
+    long long before = g_allocations;
+    for (int i = 0; i < games; ++i) {
+        game.reset(seed++);
+        game.play();
+    }
+    long long allocations = g_allocations - before;
+    if (allocations != 0) {
+        std::printf("FAILED: %lld allocations in %d warm games (expected none)\n", allocations, games);
+        return false;
+    }
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--filter TEXT] [--min-time MS]" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (arg == "--filter") {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time") {
+            options.minTimeMs = std::stod(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Not a timing: a failed check fails the run, and with it `make bench`
+    if (!checkSteadyStateAllocations(50000)) return 1;
+    
+    auto corpus = makeHandCorpus();
+
+    std::printf("%-44s %12s %14s %10s\n", "benchmark", "ns/op", "ops/s", "allocs/op");
+    benchValidation(options, corpus);
+    benchFinders(options, corpus);
+    benchPossibleContracts(options, corpus);
+    benchExtension(options, corpus);
+    benchScoreLedger(options, corpus);
+    benchHandShapes(options, corpus);
+    benchGames(options);
+    benchEndgame(options);
+    return 0;
+}
@@ -1,17 +1,413 @@
+#include "DuplicateMatch.h"
+#include "EndgameSolver.h"
+#include "EventSink.h"
 #include "Game.h"
+#include "GameLog.h"
+#include "GameServer.h"
+#include "LockstepEngine.h"
+#include "MctsStrategy.h"
+#include "PartitionSolver.h"
+#include "Profiler.h"
+#include "Tournament.h"
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <csignal>
 #include <ctime>
+#include <limits>
+#include <memory>
+#include <string>
 
-int main() {
+namespace {
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--batch GAMES] [--lockstep] [--threads N] [--seed SEED] [--game INDEX] [--players N] [--no-prompt]\n"
+              << "       [--mcts SEAT] [--iterations N] [--search-threads N] [--solver SEAT]\n"
+              << "       [--endgame SEAT] [--endgame-supply N]\n"
+              << "       [--duplicate DEALS] [--candidate greedy|mcts|solver|endgame]\n"
+              << "       [--stop-error E] [--sprt EFFECT]\n"
+              << "       [--profile FILE] [--log FILE] [--replay FILE]\n"
+              << "       [--serve PORT] [--server-threads N] [--root DIR]" << std::endl;
+}
+
+constexpr int kMaxThreads = 1024;
+constexpr int kMaxInt = std::numeric_limits<int>::max();
+constexpr long long kMaxLong = std::numeric_limits<long long>::max();
+constexpr std::uint64_t kMaxUnsigned = std::numeric_limits<std::uint64_t>::max();
+
+// Reads all of `text` as an integer in [min, max]; false for anything else
+template <typename T>
+bool parseInteger(const char* text, T min, T max, T& value) {
+    const char* end = text + std::strlen(text);
+    T parsed{};
+    auto result = std::from_chars(text, end, parsed);
+    if (result.ec != std::errc() || result.ptr != end || parsed < min || parsed > max) return false;
+    value = parsed;
+    return true;
+}
+
+// Reads all of `text` as a finite number above zero; false for anything else
+bool parsePositive(const char* text, double& value) {
+    char* end = nullptr;
+    double parsed = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !std::isfinite(parsed) || parsed <= 0.0) return false;
+    value = parsed;
+    return true;
+}
+
+// Summarizes a binary game log straight from the mapped file; with a game
+// index, rebuilds that game's final position from its records instead
+int summarizeLog(const std::string& path, bool selectGame, std::uint64_t gameIndex) {
+    GameLogReader reader(path);
+
+    if (selectGame) {
+        bool found = false;
+        reader.forEachGame([&](const LoggedGame& logged) {
+            if (found || logged.header->stream != gameIndex) return;
+            found = true;
+            Game game(logged.replay());
+            game.printResults(std::cout);
+        });
+        if (!found) {
+            std::cerr << "Game " << gameIndex << " is not in " << path << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    long long games = 0;
+    long long rounds = 0;
+    std::array<long long, GameState::kMaxPlayers> wins{};
+    std::array<long long, 4> signedByType{};
+    reader.forEachGame([&](const LoggedGame& logged) {
+        games++;
+        rounds += logged.header->rounds;
+        wins[logged.header->winner]++;
+        for (const LogRecord& record : logged) {
+            if (record.type == static_cast<std::uint8_t>(LogRecordType::SIGN)) {
+                signedByType[record.contractType]++;
+            }
+        }
+    });
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Games in log: " << games << " (" << reader.getSize() << " bytes)\n";
+    std::cout << "Rounds per game: " << (games ? static_cast<double>(rounds) / games : 0.0) << "\n";
+    for (size_t seat = 0; seat < wins.size(); ++seat) {
+        if (wins[seat]) std::cout << "  Player " << (seat + 1) << " wins: " << wins[seat] << "\n";
+    }
+    for (int type = 0; type < (int)signedByType.size(); ++type) {
+        std::cout << "  " << contractTypeToString(static_cast<ContractType>(type))
+                  << " signed: " << signedByType[type] << "\n";
+    }
+    return 0;
+}
+
+// Reads a log for --replay, reporting a bad file instead of throwing
+int replayLog(const std::string& path, bool selectGame, std::uint64_t gameIndex) {
+    try {
+        return summarizeLog(path, selectGame, gameIndex);
+    } catch (const std::exception& error) {
+        std::cerr << "Cannot read " << path << ": " << error.what() << std::endl;
+        return 1;
+    }
+}
+
+// Exit code once a run is over: 1 if any game could not be written to the log
+int finishLog(GameLogWriter* log, const std::string& path) {
+    if (!log || log->finish()) return 0;
+    std::cerr << "Failed writing game log " << path << std::endl;
+    return 1;
+}
+
+GameServer* runningServer = nullptr;
+
+void stopServer(int) {
+    if (runningServer) runningServer->stop();
+}
+
+// Serves tables until interrupted
+int serve(const ServerConfig& config) {
+    GameServer server(config);
+    runningServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    std::cout << "Merchant Empire server on http://127.0.0.1:" << server.getPort()
+              << "/ (tables at ws://127.0.0.1:" << server.getPort() << "/ws/new)" << std::endl;
+    server.run();
+    runningServer = nullptr;
+    return 0;
+}
+
+// Writes the hot-path counters collected during the run; "-" means stderr
+void writeProfile(const std::string& path) {
+    if (path.empty()) return;
+    if (!Profiler::enabled()) {
+        std::cerr << "Profiling is not compiled in; rebuild with make PROFILE=1" << std::endl;
+        return;
+    }
+    if (path == "-") {
+        Profiler::writeJson(std::cerr);
+        return;
+    }
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Cannot write profile to " << path << std::endl;
+        return;
+    }
+    Profiler::writeJson(out);
+}
+
+}
+
+int main(int argc, char* argv[]) {
     // Seed with current time for randomness, or use a fixed seed for reproducibility
-    unsigned int seed = static_cast<unsigned int>(time(nullptr));
-    
-    std::cout << "Merchant Empire - 4 Player Simulation" << std::endl;
-    std::cout << "Random seed: " << seed << std::endl;
+    std::uint64_t seed = static_cast<std::uint64_t>(time(nullptr));
+    std::uint64_t gameIndex = 0;
+    bool gameSelected = false;
+    int numPlayers = 4;
+    long long batchGames = 0;
+    int numThreads = 0;
+    bool interactive = true;
+    bool lockstep = false;
+    int mctsSeat = 0;
+    int solverSeat = 0;
+    int endgameSeat = 0;
+    EndgameConfig endgameConfig;
+    MctsConfig mctsConfig;
+    std::string profilePath;
+    std::string logPath;
+    std::string replayPath;
+    bool serving = false;
+    ServerConfig serverConfig;
+    long long duplicateDeals = 0;
+    std::string candidate = "mcts";
+    StoppingRule stopping;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no-prompt") {
+            interactive = false;
+            continue;
+        }
+        if (arg == "--lockstep") {
+            lockstep = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        bool valid = true;
+        if (arg == "--batch") {
+            valid = parseInteger(value, 1LL, kMaxLong, batchGames);
+        } else if (arg == "--threads") {
+            valid = parseInteger(value, 0, kMaxThreads, numThreads);
+        } else if (arg == "--seed") {
+            valid = parseInteger(value, std::uint64_t(0), kMaxUnsigned, seed);
+        } else if (arg == "--game") {
+            valid = parseInteger(value, std::uint64_t(0), kMaxUnsigned, gameIndex);
+            gameSelected = true;
+        } else if (arg == "--players") {
+            valid = parseInteger(value, 2, GameState::kMaxPlayers, numPlayers);
+        } else if (arg == "--mcts") {
+            valid = parseInteger(value, 0, GameState::kMaxPlayers, mctsSeat);
+        } else if (arg == "--iterations") {
+            valid = parseInteger(value, 1, kMaxInt, mctsConfig.iterations);
+        } else if (arg == "--search-threads") {
+            valid = parseInteger(value, 1, kMaxThreads, mctsConfig.threads);
+        } else if (arg == "--solver") {
+            valid = parseInteger(value, 0, GameState::kMaxPlayers, solverSeat);
+        } else if (arg == "--endgame") {
+            valid = parseInteger(value, 0, GameState::kMaxPlayers, endgameSeat);
+        } else if (arg == "--endgame-supply") {
+            valid = parseInteger(value, 1, kDeckSize, endgameConfig.maxSupply);
+        } else if (arg == "--duplicate") {
+            valid = parseInteger(value, 1LL, kMaxLong, duplicateDeals);
+        } else if (arg == "--candidate") {
+            candidate = value;
+        } else if (arg == "--stop-error") {
+            valid = parsePositive(value, stopping.targetError);
+        } else if (arg == "--sprt") {
+            valid = parsePositive(value, stopping.sprtEffect);
+        } else if (arg == "--profile") {
+            profilePath = value;
+        } else if (arg == "--log") {
+            logPath = value;
+        } else if (arg == "--replay") {
+            replayPath = value;
+        } else if (arg == "--serve") {
+            serving = true;
+            valid = parseInteger(value, 0, 65535, serverConfig.port);
+        } else if (arg == "--server-threads") {
+            valid = parseInteger(value, 0, kMaxThreads, serverConfig.numThreads);
+        } else if (arg == "--root") {
+            serverConfig.root = value;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Only duplicate deals have a paired difference for the SPRT to test
+    if (stopping.sprtEffect != 0.0 && duplicateDeals == 0) {
+        std::cerr << "--sprt needs --duplicate" << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Seats are 1-based, with 0 for none, and checked once the player count is known.
+    // A seat plays one strategy, so two options may not name the same seat.
+    int claimedSeats = 0;
+    for (int seat : {mctsSeat, solverSeat, endgameSeat}) {
+        if (seat > numPlayers) {
+            std::cerr << "Seat " << seat << " is not in a " << numPlayers << " player game" << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (seat > 0 && (claimedSeats & (1 << seat))) {
+            std::cerr << "Seat " << seat << " is given more than one strategy" << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (seat > 0) claimedSeats |= 1 << seat;
+    }
+
+    if (!replayPath.empty()) {
+        return replayLog(replayPath, gameSelected, gameIndex);
+    }
+
+    if (serving) {
+        serverConfig.seed = seed;
+        return serve(serverConfig);
+    }
+
+    // One solver, and so one position table, for every game and thread
+    std::unique_ptr<EndgameSolver> endgameSolver;
+    if (endgameSeat > 0 || (duplicateDeals > 0 && candidate == "endgame")) {
+        endgameSolver = std::make_unique<EndgameSolver>(endgameConfig);
+    }
+
+    std::unique_ptr<GameLogWriter> log;
+    if (!logPath.empty()) {
+        try {
+            log = std::make_unique<GameLogWriter>(logPath);
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (duplicateDeals > 0) {
+        DuplicateConfig config;
+        config.numDeals = duplicateDeals;
+        config.numPlayers = numPlayers;
+        config.numThreads = numThreads;
+        config.masterSeed = seed;
+        config.stopping = stopping;
+        if (candidate == "mcts") {
+            config.candidateFactory = [&] { return std::unique_ptr<Strategy>(std::make_unique<MctsStrategy>(mctsConfig)); };
+        } else if (candidate == "solver") {
+            config.candidateFactory = [] { return std::unique_ptr<Strategy>(std::make_unique<SolverStrategy>()); };
+        } else if (candidate == "endgame") {
+            config.candidateFactory = [&] { return std::unique_ptr<Strategy>(std::make_unique<EndgameStrategy>(*endgameSolver)); };
+        } else if (candidate != "greedy") {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        std::cout << "Merchant Empire - " << duplicateDeals << " duplicate deals, " << candidate << " against greedy" << std::endl;
+        std::cout << "Master seed: " << seed << std::endl;
+        std::cout << std::endl;
+
+        DuplicateMatch match(config);
+        std::cout << match.run().toString();
+        writeProfile(profilePath);
+        return 0;
+    }
+
+    if (batchGames > 0) {
+        TournamentConfig config;
+        config.numGames = batchGames;
+        config.numPlayers = numPlayers;
+        config.numThreads = numThreads;
+        config.masterSeed = seed;
+        config.stopping = stopping;
+
+        std::cout << "Merchant Empire - " << batchGames << " game batch" << std::endl;
+        std::cout << "Master seed: " << seed << std::endl;
+        std::cout << std::endl;
+
+        if (lockstep) {
+            // Every seat greedy and nothing logged
+            if (mctsSeat > 0 || solverSeat > 0 || endgameSeat > 0 || log) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            LockstepEngine engine(config);
+            std::cout << engine.run().toString();
+            writeProfile(profilePath);
+            return 0;
+        }
+
+        config.strategyFactory = [&](int seat) -> std::unique_ptr<Strategy> {
+            if (seat == mctsSeat - 1) return std::make_unique<MctsStrategy>(mctsConfig);
+            if (seat == solverSeat - 1) return std::make_unique<SolverStrategy>();
+            if (seat == endgameSeat - 1) return std::make_unique<EndgameStrategy>(*endgameSolver);
+            return nullptr;
+        };
+        config.log = log.get();
+
+        Tournament tournament(config);
+        std::cout << tournament.run().toString();
+        writeProfile(profilePath);
+        return finishLog(log.get(), logPath);
+    }
+
+    std::cout << "Merchant Empire - " << numPlayers << " Player Simulation" << std::endl;
+    std::cout << "Random seed: " << seed;
+    if (gameIndex > 0) std::cout << ", game " << gameIndex;
     std::cout << std::endl;
-    
-    Game game(4, seed);
+    std::cout << std::endl;
+
+    TextEventSink sink(std::cout, interactive);
+    MctsStrategy mcts(mctsConfig);
+    SolverStrategy solver;
+    Game game(numPlayers, seed, gameIndex);
+    game.setEventSink(&sink);
+    std::unique_ptr<GameLogSink> logSink;
+    std::unique_ptr<TeeEventSink> tee;
+    if (log) {
+        logSink = std::make_unique<GameLogSink>(*log);
+        tee = std::make_unique<TeeEventSink>(sink, *logSink);
+        game.setEventSink(tee.get());
+    }
+    if (mctsSeat > 0) {
+        game.setStrategy(mctsSeat - 1, &mcts);
+    }
+    if (solverSeat > 0) {
+        game.setStrategy(solverSeat - 1, &solver);
+    }
+    std::unique_ptr<EndgameStrategy> endgame;
+    if (endgameSeat > 0) {
+        endgame = std::make_unique<EndgameStrategy>(*endgameSolver);
+        game.setStrategy(endgameSeat - 1, endgame.get());
+    }
     game.play();
-    
-    return 0;
-}
\ No newline at end of file
+    if (logSink) logSink->flush();
+    writeProfile(profilePath);
+
+    return finishLog(log.get(), logPath);
+}
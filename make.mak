@@ -1,21 +1,35 @@
 CXX = g++
-CXXFLAGS = -std=c++17 -Wall -Wextra -O2
+CXXFLAGS = -std=c++17 -Wall -Wextra -O2 -pthread
+ifeq ($(PROFILE),1)
+CXXFLAGS += -DMERCHANT_EMPIRE_PROFILE
+endif
+ifeq ($(AVX2),1)
+CXXFLAGS += -mavx2
+endif
 TARGET = merchant_empire
-SOURCES = main.cpp Card.cpp Contract.cpp Player.cpp Game.cpp
+SOURCES = main.cpp Card.cpp Contract.cpp Player.cpp Strategy.cpp MctsStrategy.cpp PartitionSolver.cpp Game.cpp EventSink.cpp Tournament.cpp Profiler.cpp GameLog.cpp BarterEvaluator.cpp Zobrist.cpp TranspositionTable.cpp EndgameSolver.cpp ContractUniverse.cpp WebSocket.cpp ServerTable.cpp GameServer.cpp Statistics.cpp DuplicateMatch.cpp LockstepEngine.cpp
 OBJECTS = $(SOURCES:.cpp=.o)
+BENCH = merchant_bench
+BENCH_OBJECTS = bench.o $(filter-out main.o,$(OBJECTS))
 
 all: $(TARGET)
 
 $(TARGET): $(OBJECTS)
 	$(CXX) $(CXXFLAGS) -o $(TARGET) $(OBJECTS)
 
+$(BENCH): $(BENCH_OBJECTS)
+	$(CXX) $(CXXFLAGS) -o $(BENCH) $(BENCH_OBJECTS)
+
 %.o: %.cpp
 	$(CXX) $(CXXFLAGS) -c $< -o $@
 
 clean:
-	rm -f $(OBJECTS) $(TARGET)
+	rm -f $(OBJECTS) $(TARGET) bench.o $(BENCH)
 
 run: $(TARGET)
 	./$(TARGET)
 
-.PHONY: all clean run
\ No newline at end of file
+bench: $(BENCH)
+	./$(BENCH)
+
+.PHONY: all clean run bench
\ No newline at end of file